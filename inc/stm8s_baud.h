@@ -0,0 +1,74 @@
+/*
+Compile-time UART baud rate divider
+
+When F_CPU (fMASTER, Hz) and UARTn_BAUD are defined, UARTn_DIV is computed
+by compiler (rounded to nearest) and checked: build stops if real baud rate
+differs from UARTn_BAUD by more than UART_BAUD_TOLERANCE (per mille, default
+20 = 2%) or if divider is out of range 16..0xFFFF. Then UARTn_InitConst
+(ST driver) or UARTn_OpenConst (buffered engine) set BRR from constants:
+no 32-bit division and no CLK_GetClockFreq call at start.
+
+Example:
+#define F_CPU           16000000UL
+#define UART1_BAUD      115200UL
+
+UART1_InitConst(UART1_WORDLENGTH_8D, UART1_STOPBITS_1, UART1_PARITY_NO,
+                UART1_SYNCMODE_CLOCK_DISABLE, UART1_MODE_TXRX_ENABLE);
+
+Only integer constants may be used for F_CPU and UARTn_BAUD (no casts):
+they are checked by preprocessor.
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_BAUD_H
+#define __STM8S_BAUD_H
+
+#ifndef UART_BAUD_TOLERANCE
+#define UART_BAUD_TOLERANCE 20  // max baud rate error, per mille
+#endif
+
+/* Divider fMASTER/baud rounded to nearest and difference of real fMASTER/DIV
+   from wanted one, scaled by DIV (all fits 32 bits of preprocessor) */
+#define UART_DIV(f, baud)       (((f) + (baud) / 2) / (baud))
+#define UART_DIV_DIFF(f, baud)                                              \
+	((UART_DIV(f, baud) * (baud) > (f)) ? (UART_DIV(f, baud) * (baud) - (f)) \
+	: ((f) - UART_DIV(f, baud) * (baud)))
+#define UART_DIV_BAD(f, baud)                                               \
+	(UART_DIV(f, baud) < 16 || UART_DIV(f, baud) > 0xFFFF ||                \
+	UART_DIV_DIFF(f, baud) * 1000 > (f) * UART_BAUD_TOLERANCE)
+
+/* Register values for divider: BRR2 = DIV[15:12] DIV[3:0], BRR1 = DIV[11:4] */
+#define UART_BRR1(div)          ((uint8_t)((div) >> 4))
+#define UART_BRR2(div)          ((uint8_t)((((div) >> 8) & 0xF0) | ((div) & 0x0F)))
+/* Load divider to UART (UARTx or UART_Regs_TypeDef pointer): BRR2 must be
+   written first, BRR1 write updates divider */
+#define UART_SET_DIV(uart, div)                                             \
+	do { (uart)->BRR2 = UART_BRR2(div); (uart)->BRR1 = UART_BRR1(div); } while (0)
+
+#ifdef F_CPU
+#ifdef UART1_BAUD
+#if UART_DIV_BAD(F_CPU, UART1_BAUD)
+#error "UART1_BAUD can not be made from F_CPU"
+#endif
+#define UART1_DIV               UART_DIV(F_CPU, UART1_BAUD)
+#endif
+#ifdef UART2_BAUD
+#if UART_DIV_BAD(F_CPU, UART2_BAUD)
+#error "UART2_BAUD can not be made from F_CPU"
+#endif
+#define UART2_DIV               UART_DIV(F_CPU, UART2_BAUD)
+#endif
+#ifdef UART3_BAUD
+#if UART_DIV_BAD(F_CPU, UART3_BAUD)
+#error "UART3_BAUD can not be made from F_CPU"
+#endif
+#define UART3_DIV               UART_DIV(F_CPU, UART3_BAUD)
+#endif
+#ifdef UART4_BAUD
+#if UART_DIV_BAD(F_CPU, UART4_BAUD)
+#error "UART4_BAUD can not be made from F_CPU"
+#endif
+#define UART4_DIV               UART_DIV(F_CPU, UART4_BAUD)
+#endif
+#endif
+
+#endif
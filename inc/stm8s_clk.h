@@ -469,6 +469,28 @@ ITStatus CLK_GetITStatus(CLK_IT_TypeDef CLK_IT);
 void CLK_ClearITPendingBit(CLK_IT_TypeDef CLK_IT);
 #endif
 
+/* Clock change with notification. CLK_ChangeClock sets HSI or CPU divider
+   and calls every registered hook with new fMASTER, all with interrupts
+   disabled, so tick interrupt never sees old timer settings with new clock.
+   Hooks of drivers: TIM4_OSA_ClockHook, UARTx_ClockHook, I2C_ClockHook,
+   SPI_ClockHook, Delay_ClockHook, HRT_ClockHook. Example:
+     CLK_AddClockHook(TIM4_OSA_ClockHook);
+     CLK_AddClockHook(UART1_ClockHook);
+     ...
+     CLK_ChangeClock(CLK_PRESCALER_HSIDIV8);   // 16 MHz -> 2 MHz
+   Hooks are called on every change, also of CPUDIV which does not change
+   fMASTER (only Delay_ClockHook depends on CPU clock), so hook must do
+   nothing if its clock is the same. */
+//#define CLK_ChangeClock_Def
+#ifdef CLK_ChangeClock_Def
+#ifndef CLK_HOOKS
+#define CLK_HOOKS 6     /* max number of registered hooks */
+#endif
+typedef void (*CLK_Hook_TypeDef)(uint32_t fmaster);
+ErrorStatus CLK_AddClockHook(CLK_Hook_TypeDef Hook);
+uint32_t CLK_ChangeClock(CLK_Prescaler_TypeDef CLK_Prescaler);
+#endif
+
 /**
   * @}
   */
@@ -14,6 +14,60 @@
 #include "stm8s.h"
 
 void Init_Delay(void);
+void Delay_ClockHook(uint32_t fmaster);
 void delay_us(uint16_t ticks);
 void delay_ms(uint16_t ticks);
+void delay_loops(uint16_t loops);
+
+/* Short exact delays, counts are computed by compiler from F_CPU (CPU clock,
+   Hz). Loop of delay_loops takes DELAY_LOOP_CYCLES, its call and return
+   DELAY_CALL_CYCLES. Max delay 65535 loops (16 ms at 16 MHz). F_CPU is used
+   only here: delay_us follows clock set by Init_Delay / Delay_ClockHook,
+   delay_us_c must not be used when CPU clock is changed at run time. */
+#ifdef F_CPU
+#define DELAY_LOOP_CYCLES   4
+#define DELAY_CALL_CYCLES   10
+#define DELAY_CYCLES(us)    ((uint32_t)(us) * ((F_CPU) / 1000UL) / 1000UL)
+#define delay_us_c(us)                                                      \
+	do { if (DELAY_CYCLES(us) >= DELAY_CALL_CYCLES + DELAY_LOOP_CYCLES)     \
+		delay_loops((uint16_t)((DELAY_CYCLES(us) - DELAY_CALL_CYCLES) / DELAY_LOOP_CYCLES)); } while (0)
+#else
+#define delay_us_c(us)      delay_us(us)
+#endif
+
+/* Delays for OSA tasks (task level only). Delay shorter than DELAY_YIELD_US
+   is busy loop (delay_us), longer one gives control to other tasks: by high resolution
+   timer if DELAY_USE_HRTIMER is defined (up to 0x7FFF us), by OS_Delay
+   otherwise (rounded up to whole ticks, plus one for current tick). */
+#ifdef __OSA__
+#ifndef DELAY_YIELD_US
+#define DELAY_YIELD_US      200
+#endif
+#ifndef DELAY_TICK_US
+#ifdef TIM4_OSA_TICK_US
+#define DELAY_TICK_US       TIM4_OSA_TICK_US
+#else
+#define DELAY_TICK_US       1000
+#endif
+#endif
+#define DELAY_TICKS(us)     (((uint32_t)(us) + DELAY_TICK_US - 1) / DELAY_TICK_US + 1)
+
+#ifdef DELAY_USE_HRTIMER
+#include "inc/stm8s_hrtimer.h"
+#define __OS_Delay_Long(us)                                                 \
+	if ((uint32_t)(us) <= 0x7FFF) {                                         \
+		static OST_HRTIMER _delay_hrt;                                      \
+		OS_Hrtimer_Create(_delay_hrt, 0, 0);                                \
+		OS_Hrtimer_Start(_delay_hrt, (uint16_t)(us));                       \
+		OS_Hrtimer_Wait(_delay_hrt);                                        \
+	} else OS_Delay(DELAY_TICKS(us))
+#else
+#define __OS_Delay_Long(us) OS_Delay(DELAY_TICKS(us))
+#endif
+
+#define OS_Delay_us(us)                                                     \
+	do { if ((uint32_t)(us) < DELAY_YIELD_US) delay_us((uint16_t)(us));     \
+		else { __OS_Delay_Long(us); } } while (0)
+#define OS_Delay_ms(ms)     OS_Delay_us((uint32_t)(ms) * 1000UL)
+#endif
 #endif 
\ No newline at end of file
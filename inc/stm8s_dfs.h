@@ -0,0 +1,105 @@
+/*
+Dynamic frequency scaling governor (OSA)
+
+fMASTER is switched between HSI/8 (2 MHz), HSI/2 (8 MHz) and HSI (16 MHz)
+by CPU load. Load is share of time spent in scheduler passes which have run
+a task; time is measured by tick count and TIM4 counter with resolution of
+1/256 tick. Every DFS_WINDOW ticks load is compared with thresholds:
+  - more than DFS_UP_PCT % busy  - one level up at once;
+  - less than DFS_DOWN_PCT % busy during DFS_HOLD windows in row - one
+    level down.
+Task that needs full speed (burst of work) holds request, while any request
+is held clock is 16 MHz. After last release governor goes down by usual
+rules.
+
+Clock is changed by CLK_ChangeClock (CLK_ChangeClock_Def in stm8s_clk.h)
+from main loop, never from interrupt. DFS_Init registers TIM4_OSA_ClockHook,
+hooks of other used drivers (UARTx_ClockHook, Delay_ClockHook ...) must be
+registered by CLK_AddClockHook.
+
+Example:
+void Radio (void)
+{
+	for (;;)
+	{
+		OS_Bsem_Wait(packet);
+		OS_Dfs_Request();
+		OS_Dfs_Wait_Full();             // clock is 16 MHz now
+		decode_packet();
+		OS_Dfs_Release();
+	}
+}
+
+OS_Init();
+TIM4_TimerOSA(1000);
+OS_Dfs_Init();
+...
+OS_Dfs_Run();                           // instead of OS_Run()
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_DFS_H
+#define __STM8S_DFS_H
+
+#include "stm8s.h"
+#include "inc/stm8s_clk.h"
+#include "inc/stm8s_tim4.h"
+
+#ifndef CLK_ChangeClock_Def
+#error "stm8s_dfs needs CLK_ChangeClock_Def in stm8s_clk.h"
+#endif
+#if OS_PRIORITY_LEVEL == OS_PRIORITY_DISABLED
+#error "stm8s_dfs needs priority scheduler (OS_IsIdle)"
+#endif
+
+#ifndef DFS_WINDOW
+#define DFS_WINDOW      64      // ticks in load window, max 255
+#endif
+#ifndef DFS_UP_PCT
+#define DFS_UP_PCT      75      // load to go up, %
+#endif
+#ifndef DFS_DOWN_PCT
+#define DFS_DOWN_PCT    25      // load to go down, %
+#endif
+#ifndef DFS_HOLD
+#define DFS_HOLD        4       // windows of low load before going down
+#endif
+
+#define DFS_LEVEL_LOW   0       // HSI/8, 2 MHz
+#define DFS_LEVEL_MID   1       // HSI/2, 8 MHz
+#define DFS_LEVEL_FULL  2       // HSI, 16 MHz
+
+extern volatile uint8_t DFS_Ticks;      // counted by tick interrupt
+extern uint8_t          DFS_Req;        // number of full speed requests
+extern volatile uint8_t DFS_Level;      // current level
+
+#define OS_Dfs_Init()           DFS_Init()
+#define OS_Dfs_Run()            for(;;) { OS_Sched(); DFS_Sched(); }
+
+// Full speed request, each OS_Dfs_Request needs its OS_Dfs_Release
+#define OS_Dfs_Request()        DFS_Req++
+#define OS_Dfs_Release()        do { if (DFS_Req) DFS_Req--; } while (0)
+
+// Wait for full speed (task level only)
+#define OS_Dfs_Wait_Full()      OS_Wait(DFS_Level == DFS_LEVEL_FULL)
+#define OS_Dfs_Level()          (DFS_Level)
+
+/**
+  * @brief  Set full speed and register TIM4_OSA_ClockHook
+  * @param  None
+  * @retval None
+  */
+void DFS_Init(void);
+/**
+  * @brief  Count tick (called from tick interrupt after OS_Timer)
+  * @param  None
+  * @retval None
+  */
+void DFS_Tick(void);
+/**
+  * @brief  Account time of scheduler pass, check load and change clock
+  *         if needed (called from main loop after OS_Sched)
+  * @param  None
+  * @retval None
+  */
+void DFS_Sched(void);
+#endif
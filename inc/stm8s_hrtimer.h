@@ -0,0 +1,144 @@
+/*
+High-resolution one-shot timers (OSA)
+
+All timers share one free-running 16-bit timer (TIM2 by default, TIM1 if
+HRTIMER_USE_TIM1 is defined). Running timers are kept in a list sorted by
+expiry; compare register of channel 1 is loaded with the nearest expiry and
+reloaded in the capture/compare interrupt.
+
+Timer count is 1 us on TIM1 (linear prescaler) and on TIM2 when fMASTER in
+MHz is a power of two (16, 8, 4, 2, 1 MHz). Otherwise TIM2 prescaler is the
+nearest power of two above, count is longer than 1 us (24 MHz: 4/3 us) and
+times in us are converted to counts (HRT_UsToCounts, rounded up): HRT_Now
+and times computed from it are in counts. fMASTER must be at least 1 MHz.
+With CLK_ChangeClock_Def, HRT_ClockHook keeps running timers across clock
+change; count stays 1 us if both clocks are powers of two in MHz (DFS on
+HSI), otherwise users of counts (SUART) must be opened again.
+
+Example:
+OST_HRTIMER valve;
+
+void valve_off (void *arg) { GPIOD->ODR &= ~GPIO_PIN_2; }
+
+OS_Hrtimer_Init();
+OS_Hrtimer_Create(valve, valve_off, 0);
+OS_Hrtimer_Start(valve, 50);            // valve_off() in 50 us (from ISR)
+...
+OS_Hrtimer_Create(pulse, 0, 0);         // no function: task waits for expiry
+OS_Hrtimer_Start(pulse, 200);
+OS_Hrtimer_Wait(pulse);                 // task level only
+
+Function is called from interrupt: it may use only _I services of OSA
+(e.g. OS_Bsem_Set_I, OS_Flag_Set_I) and may restart own timer. Periodic
+timer is restarted by OS_Hrtimer_Advance: next expiry is counted from
+previous one, not from now, so latency of interrupt does not add up.
+Maximal time is 0x7FFF us.
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_HRTIMER_H
+#define __STM8S_HRTIMER_H
+
+#include "stm8s.h"
+
+#ifdef HRTIMER_USE_TIM1
+#define HRTIMER_TIM             TIM1
+#define HRTIMER_CC1IE           TIM1_IER_CC1IE
+#define HRTIMER_CC1IF           TIM1_SR1_CC1IF
+#define HRTIMER_CC1G            TIM1_EGR_CC1G
+#define HRTIMER_CEN             TIM1_CR1_CEN
+#define HRTIMER_PERIPHERAL      CLK_PERIPHERAL_TIMER1
+#else
+#define HRTIMER_TIM             TIM2
+#define HRTIMER_CC1IE           TIM2_IER_CC1IE
+#define HRTIMER_CC1IF           TIM2_SR1_CC1IF
+#define HRTIMER_CC1G            TIM2_EGR_CC1G
+#define HRTIMER_CEN             TIM2_CR1_CEN
+#define HRTIMER_PERIPHERAL      CLK_PERIPHERAL_TIMER2
+#endif
+
+typedef void (*OST_HRTIMER_FUNC)(void *);
+
+typedef struct S_OST_HRTIMER
+{
+	struct S_OST_HRTIMER *pNext;    // next timer in list
+	uint16_t            Expire;     // counter value of expiry
+	OST_HRTIMER_FUNC    pFunc;      // function called on expiry (may be 0)
+	void               *pArg;       // its parameter
+	volatile uint8_t    bActive;    // timer is in list
+} OST_HRTIMER;
+
+/* Count is 2^HRT_Shift / HRT_Mul us */
+extern uint8_t HRT_Mul;
+extern uint8_t HRT_Shift;
+#define HRT_COUNTS_PER_S()      ((1000000UL * HRT_Mul) >> HRT_Shift)
+
+#define OS_Hrtimer_Create(hrtimer, func, arg)   \
+	do { (hrtimer).pFunc = (func); (hrtimer).pArg = (void*)(arg); (hrtimer).bActive = 0; } while (0)
+
+#define OS_Hrtimer_Init()               HRT_Init()
+#define OS_Hrtimer_Start(hrtimer, us)   HRT_Start(&(hrtimer), us)
+#define OS_Hrtimer_Advance(hrtimer, us) HRT_Advance(&(hrtimer), us)
+#define OS_Hrtimer_Stop(hrtimer)        HRT_Stop(&(hrtimer))
+#define OS_Hrtimer_IsRun(hrtimer)       ((hrtimer).bActive)
+#define OS_Hrtimer_Now()                HRT_Now()
+
+// Wait for expiry (task level only)
+#define OS_Hrtimer_Wait(hrtimer)        OS_Wait(!(hrtimer).bActive)
+
+/**
+  * @brief  Start free-running timer with count of 1 us (on TIM2: prescaler
+  *         is smallest power of two not below fMASTER in MHz)
+  * @param  None
+  * @retval None
+  */
+void HRT_Init(void);
+/**
+  * @brief  Convert time to timer counts (rounded up)
+  * @param  Time in us, 0..0x7FFF
+  * @retval Counts
+  */
+uint16_t HRT_UsToCounts(uint16_t us);
+/**
+  * @brief  Start (restart) timer
+  * @param  Timer
+  * @param  Time in us, 0..0x7FFF
+  * @retval None
+  */
+void HRT_Start(OST_HRTIMER *pTimer, uint16_t us);
+/**
+  * @brief  Restart timer for time counted from its previous expiry (period
+  *         without drift)
+  * @param  Timer
+  * @param  Time in us, 0..0x7FFF
+  * @retval None
+  */
+void HRT_Advance(OST_HRTIMER *pTimer, uint16_t us);
+/**
+  * @brief  Stop timer, function will not be called
+  * @param  Timer
+  * @retval None
+  */
+void HRT_Stop(OST_HRTIMER *pTimer);
+/**
+  * @brief  Read counter
+  * @param  None
+  * @retval Counter value, counts
+  */
+uint16_t HRT_Now(void);
+/**
+  * @brief  Capture/compare interrupt handler (called from TIMx_CAP_COM_IRQHandler)
+  * @param  None
+  * @retval None
+  */
+void HRT_IRQHandler(void);
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Hook for CLK_ChangeClock: prescaler for new fMASTER, counter and
+  *         running timers are kept (rest of them is converted if count
+  *         changes)
+  * @param  New fMASTER, Hz
+  * @retval None
+  */
+void HRT_ClockHook(uint32_t fmaster);
+#endif
+#endif
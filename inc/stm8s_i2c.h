@@ -377,6 +377,15 @@ typedef union
 	I2C_Event_TypeDef event;
 	struct
 	{
+			/* STM8 is big endian: SR3 (high byte of event) is first in memory */
+			uint8_t msl:1; // master=1 / slave=0
+			uint8_t busy:1; //bus busy =1
+			uint8_t tra:1; // transmitter=1/ reciever=0
+			uint8_t reserv_sr3:1; // reserved
+			uint8_t gencall:1;	// generall call header=1 (slave)
+			uint8_t reserv2_sr3:2; // reserved
+			uint8_t dualf:1; // Dual flag OAR2=0 OAR2=1 (slave)
+			//-----------------------
 			uint8_t sb:1; // start bit generation=1
 			uint8_t addr:1; // address sent=1 (master)/match=1 (slave)
 			uint8_t btf:1;	// byte transfer=1
@@ -385,14 +394,6 @@ typedef union
 			uint8_t reserv_sr1:1; // reserved
 			uint8_t rxne:1; //data register not empty=1 (receiver)
 			uint8_t txe:1; // data register empty=1 (transmitters)
-			//-----------------------
-			uint8_t msl:1; // master=1 / slave=0
-			uint8_t busy:1; //bus busy =1
-			uint8_t tra:1; // transmitter=1/ reciever=0
-			uint8_t reserv_sr3:1; // reserved
-			uint8_t gencall:1;	// generall call header=1 (slave)
-			uint8_t reserv2_sr3:2; // reserved
-			uint8_t dualf:1; // Dual flag OAR2=0 OAR2=1 (slave)
 	};
 } I2CEventBit_t;
 
@@ -575,6 +576,9 @@ void I2C_DeInit(void);
 void I2C_Init(uint32_t OutputClockFrequencyHz, uint16_t OwnAddress, 
               I2C_DutyCycle_TypeDef I2C_DutyCycle, I2C_Ack_TypeDef Ack, 
               I2C_AddMode_TypeDef AddMode, uint8_t InputClockFrequencyMHz );
+#ifdef CLK_ChangeClock_Def
+void I2C_ClockHook(uint32_t fmaster);
+#endif
 void I2C_Cmd(FunctionalState NewState);
 void I2C_GeneralCallCmd(FunctionalState NewState);
 void I2C_GenerateSTART(void);
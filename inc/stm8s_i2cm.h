@@ -0,0 +1,107 @@
+/*
+I2C master transaction queue (interrupt driven, OSA)
+
+Transaction is descriptor: 7-bit address, write part, read part, flags and
+completion function. Tasks queue descriptors by I2CM_Submit and sleep till
+they are done; queued transactions go back to back, each one is run by
+I2C interrupt from START to STOP:
+  EV5 (SB)        address with direction; ACK is off before address of
+                  one byte read (ADDR is cleared by reading SR1, SR3);
+  EV6 (ADDR)      write: first byte; read of one byte: STOP; no write
+                  and no read part (address probe): STOP, I2CM_OK;
+  EV8 (TXE)       next byte, after last one TXE interrupt is off;
+  EV8_2 (BTF)     write is over: repeated START (I2CM_RESTART) or STOP
+                  and START for read part, or STOP;
+  EV7 (RXNE)      byte to buffer; ACK off and STOP before last byte.
+NACK, arbitration loss and bus error end transaction with I2CM_NACK or
+I2CM_ERROR, queue goes on. Events are decoded from I2C_GetLastEvent by
+I2CEventBit_t. ST driver stm8s_i2c.h must be enabled.
+
+Example:
+uint8_t reg = 0x00, t[2];
+I2CM_Trans_TypeDef rd = { 0x48, &reg, 1, t, 2, I2CM_RESTART };      // register read
+I2CM_Trans_TypeDef wr = { 0x50, page, 17, 0, 0, 0 };                // EEPROM page
+
+I2CM_Init(100000);
+...
+I2CM_Submit(&wr);
+I2CM_Submit(&rd);
+I2CM_Wait(&rd);                         // wr is done before rd
+if (rd.Status != I2CM_OK) ...
+
+Descriptor and buffers must not change till transaction is done. Done
+function (may be 0) is called from interrupt and may use only _I services
+of OSA. With I2CM_BSEM flag (needs OS_ENABLE_INT_BSEM) binary semaphore
+Bsem is set when transaction is done, so task may wait for it instead of
+polling Status:
+
+I2CM_Trans_TypeDef probe = { 0x50, 0, 0, 0, 0, I2CM_BSEM, 0, BS_I2C };
+I2CM_Submit(&probe);
+OS_Bsem_Wait(BS_I2C);
+present = (probe.Status == I2CM_OK);    // I2CM_NACK: no device
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_I2CM_H
+#define __STM8S_I2CM_H
+
+#include "stm8s.h"
+#include "inc/stm8s_i2c.h"
+
+/* Flags */
+#define I2CM_RESTART    ((uint8_t)0x01)     // repeated START between write and read, no STOP
+#define I2CM_BSEM       ((uint8_t)0x02)     // set binary semaphore Bsem when done
+
+/* Status */
+#define I2CM_QUEUED     0
+#define I2CM_BUSY       1
+#define I2CM_OK         2
+#define I2CM_NACK       3                   // address or data byte not acknowledged
+#define I2CM_ERROR      4                   // arbitration lost, bus error
+
+struct I2CM_Trans_struct;
+typedef void (*I2CM_Done_TypeDef)(struct I2CM_Trans_struct *t);
+
+typedef struct I2CM_Trans_struct
+{
+	uint8_t             Addr;           // 7-bit slave address
+	const uint8_t      *WrBuf;
+	uint8_t             WrLen;          // 0 - read only (both 0 - address probe)
+	uint8_t            *RdBuf;
+	uint8_t             RdLen;          // 0 - write only
+	uint8_t             Flags;
+	I2CM_Done_TypeDef   Done;           // called from interrupt, may be 0
+	uint8_t             Bsem;           // binary semaphore (I2CM_BSEM)
+	volatile uint8_t    Status;
+	struct I2CM_Trans_struct *Next;     // queue
+} I2CM_Trans_TypeDef;
+
+#define I2CM_IsDone(t)  ((t)->Status >= I2CM_OK)
+
+#ifdef __OSA__
+/* Wait till transaction is done (task level only) */
+#define I2CM_Wait(t)    OS_Wait(I2CM_IsDone(t))
+/* Submit and wait */
+#define I2CM_Transfer(t)                                                    \
+	do { I2CM_Submit(t); I2CM_Wait(t); } while (0)
+#endif
+
+/**
+  * @brief  Configure I2C as master (own address 0, 7-bit) with clock from
+  *         current fMASTER, clear queue
+  * @param  SCL frequency, Hz (up to 400000)
+  * @retval None
+  */
+void I2CM_Init(uint32_t speed);
+/**
+  * @brief  Put transaction to end of queue, start it if bus is idle
+  * @param  Transaction
+  * @retval None
+  */
+void I2CM_Submit(I2CM_Trans_TypeDef *t);
+/**
+  * @brief  I2C interrupt handler: events and errors of current transaction
+  * @param  None
+  * @retval None
+  */
+void I2CM_IRQHandler(void);
+#endif
@@ -0,0 +1,168 @@
+/*
+LIN master/slave engine (LIN 2.x enhanced checksum, classic by flag)
+
+Works on UART with LIN mode: UART1 by default, UART2 or UART3 by
+LIN_UART_NUM. Whole frame is served by receive interrupt. LIN transceiver
+gives back every byte put to bus, so node sends next byte only after echo of
+previous one has come and is equal to it (readback error otherwise); break
+is caught by LIN break detection (LBDF). Checksum is summed byte by byte in
+interrupt.
+
+Frame table of node lists frames it publishes or subscribes to, headers of
+other frames are ignored. Each frame has two data buffers:
+  - subscribed frame: interrupt receives to back buffer, on good checksum
+    buffers are swapped and Updated is set; task reads front buffer;
+  - published frame: task fills back buffer and commits it, interrupt
+    swaps buffers at start of next response and sends front buffer.
+There is no copying of data, but task must not keep pointer to front buffer
+of subscribed frame longer than one slot.
+
+Master sends headers by schedule table, slot time is in ticks of LIN time
+base: OSA tick (LIN_Tick from tick interrupt) or, with LIN_USE_HRTIMER,
+high resolution timer with period LIN_TIMEBASE_US. Response which is not
+complete at next slot is counted as error of frame.
+
+Example:
+LIN_Frame_TypeDef lin_frames[2] =
+{
+	{ 0x10, 2, LIN_PUBLISH },               // id, length, flags
+	{ 0x11, 4, LIN_SUBSCRIBE },
+};
+const LIN_Slot_TypeDef lin_table[2] = { { 0x10, 10 }, { 0x11, 10 } };
+
+LIN_Init(lin_frames, 2);
+LIN_Schedule(lin_table, 2);                 // master only
+...
+LIN_WaitBack(&lin_frames[0]);
+LIN_Back(&lin_frames[0])[0] = speed;
+LIN_Commit(&lin_frames[0]);                 // sent in next slot of frame
+...
+LIN_WaitUpdate(&lin_frames[1], 0);
+show(LIN_Data(&lin_frames[1]));
+LIN_Release(&lin_frames[1]);
+
+For simulation LIN_TX(byte) and LIN_BREAK() may be defined before this
+header: what they send must come back to LIN_RxIRQ as from bus (loopback).
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_LIN_H
+#define __STM8S_LIN_H
+
+#include "stm8s.h"
+#include "inc/stm8s_baud.h"
+#include "inc/stm8s_uart_regs.h"
+#ifdef LIN_USE_HRTIMER
+#include "inc/stm8s_hrtimer.h"
+#endif
+
+#ifndef LIN_BAUD
+#define LIN_BAUD        19200UL
+#endif
+#ifndef LIN_TIMEBASE_US
+#define LIN_TIMEBASE_US 1000    // period of LIN_USE_HRTIMER time base, max 0x7FFF
+#endif
+
+#ifndef LIN_UART_NUM
+#ifdef UART1
+#define LIN_UART_NUM    1
+#else
+#define LIN_UART_NUM    2
+#endif
+#endif
+
+/* LIN bits of CR3/CR4, the rest is in stm8s_uart_regs.h */
+#define LIN_CR3_LINEN   ((uint8_t)0x40)
+#define LIN_CR4_LBDIEN  ((uint8_t)0x40)
+#define LIN_CR4_LBDL    ((uint8_t)0x20)
+#define LIN_CR4_LBDF    ((uint8_t)0x10)
+
+#ifndef LIN_UART
+#if LIN_UART_NUM == 1
+#define LIN_UART        ((UART_Regs_TypeDef *)UART1_BaseAddress)
+#elif LIN_UART_NUM == 2
+#define LIN_UART        ((UART_Regs_TypeDef *)UART2_BaseAddress)
+#else
+#define LIN_UART        ((UART_Regs_TypeDef *)UART3_BaseAddress)
+#endif
+#endif
+#ifndef LIN_TX
+#define LIN_TX(b)       (LIN_UART->DR = (b))
+#endif
+#ifndef LIN_BREAK
+#define LIN_BREAK()     (LIN_UART->CR2 |= UART_CR2_SBK)
+#endif
+
+/* Frame flags */
+#define LIN_SUBSCRIBE   ((uint8_t)0x00)
+#define LIN_PUBLISH     ((uint8_t)0x01)     // response is sent by this node
+#define LIN_CLASSIC     ((uint8_t)0x02)     // classic checksum (LIN 1.3), always for id 60..63
+
+typedef struct
+{
+	uint8_t             Id;             // identifier 0..63
+	uint8_t             Len;            // data bytes 1..8
+	uint8_t             Flags;
+	volatile uint8_t    Front;          // buffer of task (subscribe) or to send (publish)
+	volatile uint8_t    Pending;        // publish: back buffer is committed
+	volatile uint8_t    Updated;        // subscribe: new data in front buffer
+	volatile uint8_t    Errors;         // checksum, readback, no response
+	uint8_t             Buf[2][8];
+} LIN_Frame_TypeDef;
+
+typedef struct
+{
+	uint8_t             Id;             // frame of slot
+	uint8_t             Time;           // slot time in ticks, 1..255
+} LIN_Slot_TypeDef;
+
+extern volatile uint8_t LIN_BusErrors;  // bad sync, parity of PID, framing, no echo
+
+#define LIN_Data(frame)         ((frame)->Buf[(frame)->Front])
+#define LIN_Back(frame)         ((frame)->Buf[(frame)->Front ^ 1])
+#define LIN_Commit(frame)       ((frame)->Pending = 1)
+#define LIN_CanWrite(frame)     (!(frame)->Pending)
+#define LIN_Updated(frame)      ((frame)->Updated)
+#define LIN_Release(frame)      ((frame)->Updated = 0)
+
+#ifdef __OSA__
+/* Wait for new data of subscribed frame; timeout in ticks, 0 - no timeout */
+#define LIN_WaitUpdate(frame, timeout)                                      \
+	do { if (timeout) { OS_Wait_TO(LIN_Updated(frame), timeout); }          \
+		else { OS_Wait(LIN_Updated(frame)); } } while (0)
+/* Wait till back buffer of published frame may be filled */
+#define LIN_WaitBack(frame)     OS_Wait(LIN_CanWrite(frame))
+#endif
+
+/**
+  * @brief  Configure UART for LIN (LIN_BAUD, break detection 11 bits) and
+  *         set frame table of node
+  * @param  Frames, number of frames
+  * @retval None
+  */
+void LIN_Init(LIN_Frame_TypeDef *frames, uint8_t n);
+/**
+  * @brief  Start (master) or stop (n = 0) schedule table, first header is
+  *         sent at next tick
+  * @param  Slots, number of slots
+  * @retval None
+  */
+void LIN_Schedule(const LIN_Slot_TypeDef *table, uint8_t n);
+/**
+  * @brief  Protected identifier: id with parity bits
+  * @param  Identifier 0..63
+  * @retval PID
+  */
+uint8_t LIN_Pid(uint8_t id);
+/**
+  * @brief  Time base of schedule table (called from tick interrupt)
+  * @param  None
+  * @retval None
+  */
+void LIN_Tick(void);
+/**
+  * @brief  RXNE/LBDF interrupt handler: state machine of header and response
+  * @param  None
+  * @retval None
+  */
+void LIN_RxIRQ(void);
+#endif
@@ -0,0 +1,140 @@
+/*
+Modbus RTU slave
+
+Receive interrupt puts bytes to frame buffer and updates CRC-16 at once.
+Timer (TIM3 by default, TIM2 with MB_USE_TIM2) is restarted by every byte
+and runs in one pulse mode: compare channel 1 marks T1.5, update is T3.5.
+Byte after T1.5 gap spoils frame; update interrupt ends frame, and as CRC is
+already summed, frame is checked at once (CRC of frame with its CRC is 0).
+Above 19200 baud T1.5 = 750 us and T3.5 = 1750 us (as standard says).
+
+Request is executed at task level by MB_Poll. Registers are views onto
+application data: area gives address range and pointer to uint16_t words
+(STM8 is big endian like Modbus, so bytes go as they lie in memory).
+Read response is sent by interrupt straight from area, CRC is summed while
+bytes go out. Request must fit in one area, otherwise exception 02.
+Functions: 03 read holding, 04 read input, 06 write single, 16 write
+multiple registers. Broadcast (address 0) writes without response.
+
+Example:
+struct { uint16_t speed; uint16_t mode; } setup;
+struct { uint16_t temp[4]; uint16_t status; } state;
+const MB_Area_TypeDef hold[1]  = { { 0, 2, (uint16_t *)&setup } };
+const MB_Area_TypeDef input[1] = { { 100, 5, (uint16_t *)&state } };
+const MB_Map_TypeDef map = { hold, 1, input, 1, setup_changed };
+
+MB_Init(17, 115200, MB_8E1, &map);
+for (;;) {
+	MB_Wait();
+	MB_Poll();
+}
+
+With MB_DE_PORT/MB_DE_PIN defined, RS-485 driver enable pin is high while
+response is sent.
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_MODBUS_H
+#define __STM8S_MODBUS_H
+
+#include "stm8s.h"
+#include "inc/stm8s_baud.h"
+#include "inc/stm8s_uart_regs.h"
+
+#ifndef MB_UART_NUM
+#ifdef UART1
+#define MB_UART_NUM     1
+#else
+#define MB_UART_NUM     2
+#endif
+#endif
+
+#ifdef MB_USE_TIM2
+#define MB_TIM                  TIM2
+#define MB_TIM_PERIPHERAL       CLK_PERIPHERAL_TIMER2
+#else
+#define MB_TIM                  TIM3
+#define MB_TIM_PERIPHERAL       CLK_PERIPHERAL_TIMER3
+#endif
+#define MB_TIM_CEN      ((uint8_t)0x01)
+#define MB_TIM_OPM      ((uint8_t)0x08)
+#define MB_TIM_UIF      ((uint8_t)0x01)
+#define MB_TIM_CC1IF    ((uint8_t)0x02)
+
+#ifndef MB_UART
+#if MB_UART_NUM == 1
+#define MB_UART         ((UART_Regs_TypeDef *)UART1_BaseAddress)
+#elif MB_UART_NUM == 2
+#define MB_UART         ((UART_Regs_TypeDef *)UART2_BaseAddress)
+#else
+#define MB_UART         ((UART_Regs_TypeDef *)UART3_BaseAddress)
+#endif
+#endif
+
+/* Character format: CR1 bits (M, PCEN, PS) and flag of 2 stop bits */
+#define MB_8E1          (UART_CR1_M | UART_CR1_PCEN)
+#define MB_8O1          (UART_CR1_M | UART_CR1_PCEN | UART_CR1_PS)
+#define MB_8N2          ((uint8_t)0x80)
+
+#define MB_BUF_SIZE     256
+
+typedef struct
+{
+	uint16_t            Addr;           // first register
+	uint16_t            Num;            // number of registers
+	uint16_t           *Data;           // application data
+} MB_Area_TypeDef;
+
+typedef struct
+{
+	const MB_Area_TypeDef *Hold;        // holding registers (read/write)
+	uint8_t             NHold;
+	const MB_Area_TypeDef *Input;       // input registers (read only)
+	uint8_t             NInput;
+	void (*Written)(uint16_t addr, uint16_t num);   // after write, may be 0
+} MB_Map_TypeDef;
+
+#define MB_IDLE         0       // receiving
+#define MB_READY        1       // request for this slave is in buffer
+#define MB_SEND         2       // response is being sent
+
+extern volatile uint8_t MB_State;
+extern volatile uint8_t MB_Errors;      // frames with bad CRC, gap or character error
+
+#ifdef __OSA__
+#define MB_Wait()       OS_Wait(MB_State == MB_READY)
+#endif
+
+/**
+  * @brief  Configure UART and timer, start receiving
+  * @param  Slave address 1..247
+  * @param  Baud rate
+  * @param  Format: MB_8E1, MB_8O1, MB_8N2
+  * @param  Register map
+  * @retval None
+  */
+void MB_Init(uint8_t addr, uint32_t baud, uint8_t format, const MB_Map_TypeDef *map);
+/**
+  * @brief  Execute received request and start response (task level)
+  * @param  None
+  * @retval 1 if request was executed
+  */
+uint8_t MB_Poll(void);
+/**
+  * @brief  RXNE interrupt handler: byte to frame, CRC, restart of timer
+  * @param  None
+  * @retval None
+  */
+void MB_RxIRQ(void);
+/**
+  * @brief  TXE/TC interrupt handler: next byte of response
+  * @param  None
+  * @retval None
+  */
+void MB_TxIRQ(void);
+/**
+  * @brief  Timer update interrupt handler: T3.5 gap, end of frame
+  * @param  None
+  * @retval None
+  */
+void MB_TimerIRQ(void);
+#endif
@@ -306,6 +306,9 @@ void SPI_Init(SPI_FirstBit_TypeDef FirstBit,
               SPI_ClockPhase_TypeDef ClockPhase, 
               SPI_DataDirection_TypeDef Data_Direction, 
               SPI_NSS_TypeDef Slave_Management, uint8_t CRCPolynomial);
+#ifdef CLK_ChangeClock_Def
+void SPI_ClockHook(uint32_t fmaster);
+#endif
 void SPI_Cmd(FunctionalState NewState);
 void SPI_ITConfig(SPI_IT_TypeDef SPI_IT, FunctionalState NewState);
 void SPI_SendData(uint8_t Data);
@@ -0,0 +1,180 @@
+/*
+Software UART channels (8N1) on any GPIO pins
+
+All channels share free-running timer of high resolution timers (TIM2 or,
+with HRTIMER_USE_TIM1, TIM1): compare channel 2 is loaded with nearest bit
+event of all channels and reloaded in capture/compare interrupt, which
+serves every event due within SUART_EARLY timer counts at once.
+  - receive: falling edge of start bit on RX pin gives EXTI interrupt of its
+    port (port is set to falling edge only); time of edge is read from
+    timer, pin interrupt is disabled and bits are sampled in middle by
+    compare interrupts: 0.5 bit after edge (start bit must still be 0),
+    then each bit time; after stop bit pin interrupt is enabled again;
+  - transmit: start, data and stop bits are written to TX pin by compare
+    interrupts, next byte is taken from ring at end of stop bit.
+Bit time is whole timer counts (1 us at 16, 8, 2 MHz; see stm8s_hrtimer.h):
+with 1 us count error of baud rate is below 0.5% up to 19200 baud (9600:
+104 us, 19200: 52 us); 38400 (26 us, 0.16%) works when other interrupts
+are short. Bit time is taken at SUART_Open: after clock change which
+changes timer count, channels must be opened again (reopened channel is
+not added twice, its rings are cleared). Rings and task macros are as in
+UART engine (stm8s_uart.h).
+
+Example:
+SUART_CHAN_DEFINE(gps, GPIOD, GPIO_PIN_2, GPIOD, GPIO_PIN_3, 16, 64);  // TX, RX, ring sizes
+SUART_CHAN_DEFINE(rfid, 0, 0, GPIOC, GPIO_PIN_4, 0, 32);               // receive only
+
+OS_Hrtimer_Init();                      // timer must run first
+SUART_Open(&gps, 9600);
+SUART_Open(&rfid, 9600);
+...
+SUART_Write(&gps, cmd, 6);
+SUART_Read(&rfid, tag, 14, 100);        // up to 100 ticks for 14 bytes
+
+CPU cost: one interrupt per bit event (10 per byte and direction), events of
+several channels closer than SUART_EARLY share one interrupt. Load is about
+sum(10 * bytes per second * cycles per bit) / fMASTER. Cycles per bit are
+measured with SUART_BENCHMARK (TIM1 counts fMASTER clocks, so it needs
+high resolution timers on TIM2): SUART_BenchCycles / SUART_BenchBits is
+mean cost of one bit event in handler, SUART_BenchMax is longest handler
+run; interrupt entry and return come on top.
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_SUART_H
+#define __STM8S_SUART_H
+
+#include "stm8s.h"
+#include "inc/stm8s_hrtimer.h"
+
+#ifndef SUART_MAX_CHANNELS
+#define SUART_MAX_CHANNELS  4
+#endif
+#ifndef SUART_EARLY
+#define SUART_EARLY         2       // timer counts: event so close is served now
+#endif
+
+#ifdef HRTIMER_USE_TIM1
+#define SUART_CC2IE         TIM1_IER_CC2IE
+#define SUART_CC2IF         TIM1_SR1_CC2IF
+#define SUART_CC2G          TIM1_EGR_CC2G
+#else
+#define SUART_CC2IE         TIM2_IER_CC2IE
+#define SUART_CC2IF         TIM2_SR1_CC2IF
+#define SUART_CC2G          TIM2_EGR_CC2G
+#endif
+
+#if defined(SUART_BENCHMARK) && defined(HRTIMER_USE_TIM1)
+#error "SUART_BENCHMARK needs TIM1, high resolution timers must be on TIM2"
+#endif
+
+typedef struct
+{
+	GPIO_TypeDef       *TxPort;         // 0 - receive only
+	uint8_t             TxPin;
+	GPIO_TypeDef       *RxPort;         // 0 - transmit only
+	uint8_t             RxPin;
+	uint8_t            *TxBuf;
+	uint8_t            *RxBuf;
+	uint8_t             TxMask;         // ring size - 1
+	uint8_t             RxMask;
+	volatile uint8_t    TxIn;           // indexes run freely, number of
+	volatile uint8_t    TxOut;          // bytes is (uint8_t)(In - Out)
+	volatile uint8_t    RxIn;
+	volatile uint8_t    RxOut;
+	volatile uint8_t    RxErrors;       // bad stop bit or ring was full
+	uint16_t            Bit;            // bit time, timer counts
+	uint16_t            TxDue;          // timer count of next TX event
+	uint16_t            TxShift;        // start, data and stop bits left
+	uint8_t             TxCnt;          // number of them
+	volatile uint8_t    TxOn;           // TX events are scheduled
+	uint16_t            RxDue;
+	uint8_t             RxShift;
+	uint8_t             RxCnt;          // samples left, 0 - waiting for start bit
+	const uint8_t      *WrPtr;          // SUART_Write in progress
+	uint8_t             WrLeft;
+	uint8_t            *RdPtr;          // SUART_Read in progress
+	uint8_t             RdLeft;
+	uint8_t             RdDone;
+} SUART_TypeDef;
+
+/* Ring sizes: powers of two, max 128; 0 for unused direction (its port
+   must be 0). Wrong size stops compilation: array of size -1 (#if can not
+   be used in macro). */
+#define SUART_SIZE_OK(size)     (((size) & ((size) - 1)) == 0 && (size) <= 128)
+#define SUART_CHAN_DEFINE(ch, txport, txpin, rxport, rxpin, txsize, rxsize) \
+	typedef char ch##_ring_size_must_be_power_of_two_max_128               \
+		[(SUART_SIZE_OK(txsize) && SUART_SIZE_OK(rxsize)) ? 1 : -1];        \
+	static uint8_t ch##_TxBuf[(txsize) ? (txsize) : 1];                     \
+	static uint8_t ch##_RxBuf[(rxsize) ? (rxsize) : 1];                     \
+	SUART_TypeDef ch = { txport, txpin, rxport, rxpin,                      \
+		ch##_TxBuf, ch##_RxBuf,                                             \
+		(uint8_t)((txsize) ? (txsize) - 1 : 0), (uint8_t)((rxsize) ? (rxsize) - 1 : 0) }
+
+#ifdef SUART_BENCHMARK
+extern volatile uint32_t SUART_BenchCycles;    // fMASTER clocks in handler
+extern volatile uint32_t SUART_BenchBits;      // bit events served
+extern volatile uint16_t SUART_BenchMax;       // longest handler run
+#endif
+
+/**
+  * @brief  Configure pins (TX push-pull high, RX input with pull-up and
+  *         interrupt, its port falling edge only), clear rings and add
+  *         channel to timer if it is not there (high resolution timers
+  *         must be started)
+  * @param  Channel
+  * @param  Baud rate, max 38400
+  * @retval ERROR if SUART_MAX_CHANNELS other channels are open, SUCCESS
+  *         otherwise
+  */
+ErrorStatus SUART_Open(SUART_TypeDef *ch, uint32_t baud);
+/**
+  * @brief  Put bytes to transmit ring, as many as fit
+  * @param  Channel, data, number of bytes
+  * @retval Number of bytes put (0 for receive only channel)
+  */
+uint8_t SUART_Put(SUART_TypeDef *ch, const uint8_t *buf, uint8_t len);
+/**
+  * @brief  Take received bytes from ring, as many as there are
+  * @param  Channel, buffer, size of buffer
+  * @retval Number of bytes taken (0 for transmit only channel)
+  */
+uint8_t SUART_Get(SUART_TypeDef *ch, uint8_t *buf, uint8_t len);
+#define SUART_RxCount(ch)       ((uint8_t)((ch)->RxIn - (ch)->RxOut))
+#define SUART_TxIdle(ch)        (!(ch)->TxOn)
+/* Steps of SUART_Write / SUART_Read, evaluated by OS_Wait of the task */
+void SUART_WriteStart(SUART_TypeDef *ch, const uint8_t *buf, uint8_t len);
+uint8_t SUART_WriteStep(SUART_TypeDef *ch);
+void SUART_ReadStart(SUART_TypeDef *ch, uint8_t *buf, uint8_t len);
+uint8_t SUART_ReadStep(SUART_TypeDef *ch);
+#define SUART_ReadDone(ch)      ((ch)->RdDone)
+/**
+  * @brief  Capture/compare interrupt handler (called from
+  *         TIMx_CAP_COM_IRQHandler of high resolution timers)
+  * @param  None
+  * @retval None
+  */
+void SUART_IRQHandler(void);
+/**
+  * @brief  EXTI interrupt handler of port: start bit of channels on it
+  * @param  Port
+  * @retval None
+  */
+void SUART_ExtiIRQ(GPIO_TypeDef *port);
+
+#ifdef __OSA__
+/* Put all bytes to ring, wait while it is full */
+#define SUART_Write(ch, buf, len)                                           \
+	do { SUART_WriteStart(ch, buf, len); OS_Wait(SUART_WriteStep(ch)); } while (0)
+/* Get len bytes; timeout in ticks, 0 - no timeout */
+#define SUART_Read(ch, buf, len, timeout)                                   \
+	do { SUART_ReadStart(ch, buf, len);                                     \
+		if (timeout) { OS_Wait_TO(SUART_ReadStep(ch), timeout); }           \
+		else { OS_Wait(SUART_ReadStep(ch)); } } while (0)
+/* Wait for received byte; timeout in ticks, 0 - no timeout */
+#define SUART_WaitRx(ch, timeout)                                           \
+	do { if (timeout) { OS_Wait_TO(SUART_RxCount(ch), timeout); }           \
+		else { OS_Wait(SUART_RxCount(ch)); } } while (0)
+/* Wait till all bytes are sent (end of last stop bit) */
+#define SUART_WaitTx(ch)        OS_Wait(SUART_TxIdle(ch))
+#endif
+#endif
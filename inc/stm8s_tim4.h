@@ -227,6 +227,27 @@ void TIM4_ClearITPendingBit(TIM4_IT_TypeDef TIM4_IT);
  
 #ifdef __OSA__ 
 void TIM4_TimerOSA(uint16_t us);
+#ifdef CLK_ChangeClock_Def
+void TIM4_OSA_ClockHook(uint32_t fmaster);
+#endif
+#if defined(F_CPU) && defined(TIM4_OSA_TICK_US)
+void TIM4_TimerOSAConst(void);
+#endif
+#ifdef TIM4_OSA_FRAC
+/* Fractional tick mode: called from tick interrupt */
+void TIM4_OSA_FracTick(void);
+#endif
+#ifdef OS_ENABLE_TIME32
+uint32_t OS_GetTime_us(void);
+#endif
+#ifdef OS_TIMER_BENCHMARK
+/* Cycles spent in OS_Timer() by tick interrupt: last and maximal.
+   TIM1 is used as free-running CPU clock counter. */
+extern volatile uint16_t TIM4_OSA_Cycles;
+extern volatile uint16_t TIM4_OSA_CyclesMax;
+void TIM4_OSA_BenchStart(void);
+void TIM4_OSA_BenchStop(void);
+#endif
 #endif
 
 /**
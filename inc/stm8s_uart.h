@@ -0,0 +1,402 @@
+/*
+Buffered UART engine for UART1..UART4
+
+One code for all UARTs of the chip: port descriptor keeps pointer to
+registers (layout of SR..CR4 is the same in UART1..UART4), rings and state.
+Interrupt handlers of each UART only call UART_TxIRQ/UART_RxIRQ with its
+port. Port n is enabled by UARTn_BUFFERED, ring sizes by UARTn_TX_SIZE and
+UARTn_RX_SIZE (powers of two, max 128, default 32 and 64). ST drivers
+stm8s_uartN.c are not needed for it.
+
+Example:
+#define UART1_BUFFERED
+
+UART_Open(&UART_Port1, 115200, UART_8N1);      // or, with F_CPU and UART1_BAUD
+                                                // defined, UART1_OpenConst(UART_8N1)
+...
+UART1_Write(hello, 5);                  // task waits for place in ring
+UART1_Read(cmd, 4, 100);                // up to 100 ticks for 4 bytes
+if (OS_IsTimeout()) n = UART1_ReadDone();
+
+Write and read macros are for task level only; one task at a time may use
+each of them on one port.
+
+Frame mode (UARTn_FRAME_SIZE defined, max 255): bytes go to frame buffer
+instead of ring, end of frame is idle line (IDLE interrupt); longer frames
+are cut. Task is woken once per frame and gets pointer and length. There
+are two frame buffers: next frame is received while task handles previous
+one; if it is complete before UART_FrameRelease, it is lost (FrameLost is
+incremented).
+
+UART_FrameMode(&UART_Port1, ENABLE);
+for (;;) {
+	UART_WaitFrame(&UART_Port1, 0);
+	handle(UART_FrameData(&UART_Port1), UART_FrameLen(&UART_Port1));
+	UART_FrameRelease(&UART_Port1);
+}
+
+Scatter-gather transmit: list of caller's segments is sent by interrupts
+without copying to ring. Segments and list must not change till done
+function is called (from interrupt, after TC: last bit has left shift
+register). Bytes which are in ring at UART_TxSubmit are sent before list,
+bytes put later - after done function, so they are not on line before TC.
+
+void sent (UART_Port_TypeDef *port) { OS_Bsem_Set_I(BS_SENT); }
+
+UART_Iov_TypeDef frame[3] = { {hdr, 4}, {data, 0}, {crc, 2} };
+frame[1].Len = n;
+UART_TxSubmit(&UART_Port1, frame, 3, sent);
+OS_Bsem_Wait(BS_SENT);
+
+RS-485 multi-drop bus (UART_Rs485Open): 9-bit frames, 9th bit marks address
+byte (address mark wake-up). Receiver of node sits in hardware mute and gets
+no interrupts till address byte whose low 4 bits are equal to low 4 bits of
+its address; then whole address is compared by software and on mismatch
+receiver goes back to mute. So node is woken only by frames for it (and for
+addresses with the same low 4 bits, at most one byte). Address byte itself
+is not put to ring/frame. Node stays awake till next address of other node.
+Driver enable pin (DE, with /RE tied to it) is set before first byte and
+released from TC interrupt when ring and list are empty: bus is free right
+after stop bit of last byte. Frame to other node is sent by UART_Rs485Send:
+address byte with mark, then list as in UART_TxSubmit.
+
+UART_Rs485Open(&UART_Port2, 38400, 0x15, GPIOD, GPIO_PIN_7);
+UART_FrameMode(&UART_Port2, ENABLE);
+for (;;) {
+	UART_WaitFrame(&UART_Port2, 0);             // request to node 0x15
+	n = handle(UART_FrameData(&UART_Port2), UART_FrameLen(&UART_Port2), reply);
+	UART_FrameRelease(&UART_Port2);
+	answer[0].Data = reply; answer[0].Len = n;
+	UART_Rs485Send(&UART_Port2, MASTER_ADDR, answer, 1, 0);
+	UART_WaitSubmit(&UART_Port2);
+}
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_UART_H
+#define __STM8S_UART_H
+
+#include "stm8s.h"
+#include "inc/stm8s_baud.h"
+#include "inc/stm8s_uart_regs.h"
+
+/* Frame format for UART_Open: CR1 bits and flag of 2 stop bits */
+#define UART_STOPBITS_2 ((uint8_t)0x80)
+#define UART_8N1        ((uint8_t)0)
+#define UART_8E1        (UART_CR1_M | UART_CR1_PCEN)
+#define UART_8O1        (UART_CR1_M | UART_CR1_PCEN | UART_CR1_PS)
+#define UART_7E1        UART_CR1_PCEN
+#define UART_7O1        (UART_CR1_PCEN | UART_CR1_PS)
+#define UART_8N2        UART_STOPBITS_2
+
+typedef struct
+{
+	const uint8_t      *Data;
+	uint16_t            Len;
+} UART_Iov_TypeDef;
+
+struct UART_Port_struct;
+typedef void (*UART_Done_TypeDef)(struct UART_Port_struct *port);
+
+typedef struct UART_Port_struct
+{
+	UART_Regs_TypeDef  *Regs;
+	uint8_t            *TxBuf;
+	uint8_t            *RxBuf;
+	uint8_t             TxMask;         // ring size - 1
+	uint8_t             RxMask;
+	uint8_t            *FrameBuf;       // two frame buffers (0 - no frame mode)
+	uint8_t             FrameSize;      // size of one of them
+	volatile uint8_t    TxIn;           // indexes run freely, number of
+	volatile uint8_t    TxOut;          // bytes is (uint8_t)(In - Out)
+	volatile uint8_t    RxIn;
+	volatile uint8_t    RxOut;
+	volatile uint8_t    RxOverflow;     // byte lost: ring was full
+	uint32_t            BaudRate;       // set by UART_Open
+	const uint8_t      *WrPtr;          // UART_Write in progress
+	uint8_t             WrLeft;
+	uint8_t            *RdPtr;          // UART_Read in progress
+	uint8_t             RdLeft;
+	uint8_t             RdDone;
+	uint8_t             FrameMode;      // UART_FrameMode enabled
+	uint8_t             FrameCur;       // buffer being received: 0/1
+	uint8_t             FrameIdx;       // bytes received to it
+	volatile uint8_t    FrameLen;       // length of ready frame, 0 - none
+	uint8_t             FrameReady;     // buffer of ready frame
+	volatile uint8_t    FrameLost;      // frames lost: buffer was busy
+	const UART_Iov_TypeDef *Iov;        // next segment of UART_TxSubmit
+	uint8_t             IovN;           // segments left, with current one
+	const uint8_t      *IovPtr;         // current segment
+	uint16_t            IovLeft;
+	uint8_t             IovMark;        // TxIn at submit: list goes after it
+	volatile uint8_t    IovBusy;        // list is not sent yet
+	UART_Done_TypeDef   IovDone;
+	volatile uint8_t    IovSent;        // last byte of list is given to UART
+	GPIO_TypeDef       *DePort;         // RS-485 driver enable, 0 - none
+	uint8_t             DePin;
+	uint8_t             Addr;           // RS-485 address of node
+	volatile uint8_t    AddrPending;    // address byte goes before list
+	uint8_t             AddrByte;
+} UART_Port_TypeDef;
+
+#define UART_PORT_DEFINE(port, regs, txsize, rxsize)                        \
+	static uint8_t port##_TxBuf[txsize];                                    \
+	static uint8_t port##_RxBuf[rxsize];                                    \
+	UART_Port_TypeDef port = { (UART_Regs_TypeDef *)(regs),                \
+		port##_TxBuf, port##_RxBuf, (txsize) - 1, (rxsize) - 1, 0, 0 }
+
+#define UART_PORT_DEFINE_FRAME(port, regs, txsize, rxsize, framesize)       \
+	static uint8_t port##_TxBuf[txsize];                                    \
+	static uint8_t port##_RxBuf[rxsize];                                    \
+	static uint8_t port##_FrameBuf[2 * (framesize)];                        \
+	UART_Port_TypeDef port = { (UART_Regs_TypeDef *)(regs),                \
+		port##_TxBuf, port##_RxBuf, (txsize) - 1, (rxsize) - 1,             \
+		port##_FrameBuf, framesize }
+
+#define UART_SIZE_OK(size)  (((size) & ((size) - 1)) == 0 && (size) <= 128)
+
+#ifdef UART1_BUFFERED
+#ifndef UART1_TX_SIZE
+#define UART1_TX_SIZE 32
+#endif
+#ifndef UART1_RX_SIZE
+#define UART1_RX_SIZE 64
+#endif
+#if !UART_SIZE_OK(UART1_TX_SIZE) || !UART_SIZE_OK(UART1_RX_SIZE)
+#error "UART1_TX_SIZE and UART1_RX_SIZE must be power of two, max 128"
+#endif
+extern UART_Port_TypeDef UART_Port1;
+#ifdef UART1_DIV
+#define UART1_OpenConst(format)    UART_OpenDiv(&UART_Port1, UART1_BAUD, UART1_DIV, format)
+#endif
+#endif
+
+#ifdef UART2_BUFFERED
+#ifndef UART2_TX_SIZE
+#define UART2_TX_SIZE 32
+#endif
+#ifndef UART2_RX_SIZE
+#define UART2_RX_SIZE 64
+#endif
+#if !UART_SIZE_OK(UART2_TX_SIZE) || !UART_SIZE_OK(UART2_RX_SIZE)
+#error "UART2_TX_SIZE and UART2_RX_SIZE must be power of two, max 128"
+#endif
+extern UART_Port_TypeDef UART_Port2;
+#ifdef UART2_DIV
+#define UART2_OpenConst(format)    UART_OpenDiv(&UART_Port2, UART2_BAUD, UART2_DIV, format)
+#endif
+#endif
+
+#ifdef UART3_BUFFERED
+#ifndef UART3_TX_SIZE
+#define UART3_TX_SIZE 32
+#endif
+#ifndef UART3_RX_SIZE
+#define UART3_RX_SIZE 64
+#endif
+#if !UART_SIZE_OK(UART3_TX_SIZE) || !UART_SIZE_OK(UART3_RX_SIZE)
+#error "UART3_TX_SIZE and UART3_RX_SIZE must be power of two, max 128"
+#endif
+extern UART_Port_TypeDef UART_Port3;
+#ifdef UART3_DIV
+#define UART3_OpenConst(format)    UART_OpenDiv(&UART_Port3, UART3_BAUD, UART3_DIV, format)
+#endif
+#endif
+
+#ifdef UART4_BUFFERED
+#ifndef UART4_TX_SIZE
+#define UART4_TX_SIZE 32
+#endif
+#ifndef UART4_RX_SIZE
+#define UART4_RX_SIZE 64
+#endif
+#if !UART_SIZE_OK(UART4_TX_SIZE) || !UART_SIZE_OK(UART4_RX_SIZE)
+#error "UART4_TX_SIZE and UART4_RX_SIZE must be power of two, max 128"
+#endif
+extern UART_Port_TypeDef UART_Port4;
+#ifdef UART4_DIV
+#define UART4_OpenConst(format)    UART_OpenDiv(&UART_Port4, UART4_BAUD, UART4_DIV, format)
+#endif
+#endif
+
+/**
+  * @brief  Configure UART (baud rate from current fMASTER, frame format),
+  *         enable transmitter, receiver and receive interrupt.
+  * @param  Port
+  * @param  Baud rate
+  * @param  Format: UART_8N1, UART_8E1 ...
+  * @retval None
+  */
+void UART_Open(UART_Port_TypeDef *port, uint32_t baud, uint8_t format);
+/**
+  * @brief  Same as UART_Open with divider fMASTER/baud given by caller, e.g.
+  *         computed by compiler (UARTn_OpenConst, see stm8s_baud.h)
+  * @param  Port
+  * @param  Baud rate (for UART_ClockHook)
+  * @param  Divider
+  * @param  Format: UART_8N1, UART_8E1 ...
+  * @retval None
+  */
+void UART_OpenDiv(UART_Port_TypeDef *port, uint32_t baud, uint16_t div, uint8_t format);
+/**
+  * @brief  Clear rings and enable receive interrupt (for UART configured by
+  *         other means, e.g. UARTx_Init)
+  * @param  Port
+  * @retval None
+  */
+void UART_BufInit(UART_Port_TypeDef *port);
+/**
+  * @brief  Put bytes to transmit ring, as many as fit
+  * @param  Port, data, number of bytes
+  * @retval Number of bytes put
+  */
+uint8_t UART_Put(UART_Port_TypeDef *port, const uint8_t *buf, uint8_t len);
+/**
+  * @brief  Take received bytes from ring, as many as there are
+  * @param  Port, buffer, size of buffer
+  * @retval Number of bytes taken
+  */
+uint8_t UART_Get(UART_Port_TypeDef *port, uint8_t *buf, uint8_t len);
+/**
+  * @brief  Number of received bytes in ring
+  * @param  Port
+  * @retval Number of bytes
+  */
+uint8_t UART_RxCount(UART_Port_TypeDef *port);
+/**
+  * @brief  Transmission is over: ring is empty and last byte is sent
+  * @param  Port
+  * @retval 1 if all is sent
+  */
+uint8_t UART_TxIdle(UART_Port_TypeDef *port);
+/* Steps of UART_Write / UART_Read, evaluated by OS_Wait of the task */
+void UART_WriteStart(UART_Port_TypeDef *port, const uint8_t *buf, uint8_t len);
+uint8_t UART_WriteStep(UART_Port_TypeDef *port);
+void UART_ReadStart(UART_Port_TypeDef *port, uint8_t *buf, uint8_t len);
+uint8_t UART_ReadStep(UART_Port_TypeDef *port);
+/**
+  * @brief  Number of bytes got by last UART_Read (less than asked on timeout)
+  * @param  Port
+  * @retval Number of bytes
+  */
+uint8_t UART_ReadDone(UART_Port_TypeDef *port);
+/**
+  * @brief  Enable or disable frame mode (port must have frame buffers)
+  * @param  Port, ENABLE or DISABLE
+  * @retval None
+  */
+void UART_FrameMode(UART_Port_TypeDef *port, FunctionalState NewState);
+/**
+  * @brief  Release frame got by UART_WaitFrame, buffer is free for next one
+  * @param  Port
+  * @retval None
+  */
+void UART_FrameRelease(UART_Port_TypeDef *port);
+#define UART_FrameReady(port)   ((port)->FrameLen != 0)
+#define UART_FrameLen(port)     ((port)->FrameLen)
+#define UART_FrameData(port)    ((port)->FrameBuf + ((port)->FrameReady ? (port)->FrameSize : 0))
+
+/**
+  * @brief  Start scatter-gather transmit
+  * @param  Port
+  * @param  Segments (may have zero length)
+  * @param  Number of segments
+  * @param  Function called from interrupt when all is sent, may be 0
+  * @retval ERROR if previous list is not sent yet, SUCCESS otherwise
+  */
+ErrorStatus UART_TxSubmit(UART_Port_TypeDef *port, const UART_Iov_TypeDef *iov,
+                          uint8_t n, UART_Done_TypeDef done);
+#define UART_TxBusy(port)       ((port)->IovBusy)
+
+/**
+  * @brief  Configure UART as RS-485 node: 9-bit frames, address mark wake-up,
+  *         receiver in mute, DE pin as push-pull output, low (receive)
+  * @param  Port
+  * @param  Baud rate
+  * @param  Address of node
+  * @param  Port of DE pin (0 - no DE pin), pin mask
+  * @retval None
+  */
+void UART_Rs485Open(UART_Port_TypeDef *port, uint32_t baud, uint8_t addr,
+                    GPIO_TypeDef *deport, uint8_t depin);
+/**
+  * @brief  Send address byte (with 9th bit set) and list of segments
+  * @param  Port
+  * @param  Address of destination node
+  * @param  Segments, number of segments, done function as in UART_TxSubmit
+  * @retval ERROR if previous list is not sent yet, SUCCESS otherwise
+  */
+ErrorStatus UART_Rs485Send(UART_Port_TypeDef *port, uint8_t addr,
+                           const UART_Iov_TypeDef *iov, uint8_t n, UART_Done_TypeDef done);
+/* Back to mute till next address byte for this node */
+#define UART_Rs485Mute(port)    ((port)->Regs->CR2 |= UART_CR2_RWU)
+
+/**
+  * @brief  TXE/TC interrupt handler: next byte from ring or segment list,
+  *         TXE interrupt is disabled when there is nothing to send
+  * @param  Port
+  * @retval None
+  */
+void UART_TxIRQ(UART_Port_TypeDef *port);
+/**
+  * @brief  RXNE/IDLE interrupt handler: byte to ring or frame buffer
+  * @param  Port
+  * @retval None
+  */
+void UART_RxIRQ(UART_Port_TypeDef *port);
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Hook for CLK_ChangeClock: new BRR for all opened ports
+  * @param  New fMASTER, Hz
+  * @retval None
+  */
+void UART_ClockHook(uint32_t fmaster);
+#endif
+
+#ifdef __OSA__
+/* Put all bytes to ring, wait while it is full */
+#define UART_Write(port, buf, len)                                          \
+	do { UART_WriteStart(port, buf, len); OS_Wait(UART_WriteStep(port)); } while (0)
+/* Get len bytes; timeout in ticks, 0 - no timeout */
+#define UART_Read(port, buf, len, timeout)                                  \
+	do { UART_ReadStart(port, buf, len);                                    \
+		if (timeout) { OS_Wait_TO(UART_ReadStep(port), timeout); }          \
+		else { OS_Wait(UART_ReadStep(port)); } } while (0)
+/* Wait for received byte; timeout in ticks, 0 - no timeout */
+#define UART_WaitRx(port, timeout)                                          \
+	do { if (timeout) { OS_Wait_TO(UART_RxCount(port), timeout); }          \
+		else { OS_Wait(UART_RxCount(port)); } } while (0)
+/* Wait for complete frame; timeout in ticks, 0 - no timeout */
+#define UART_WaitFrame(port, timeout)                                       \
+	do { if (timeout) { OS_Wait_TO(UART_FrameReady(port), timeout); }       \
+		else { OS_Wait(UART_FrameReady(port)); } } while (0)
+/* Wait till list of UART_TxSubmit is sent */
+#define UART_WaitSubmit(port)   OS_Wait(!UART_TxBusy(port))
+/* Wait till all bytes are sent */
+#define UART_WaitTx(port)       OS_Wait(UART_TxIdle(port))
+
+#define UART1_Write(buf, len)           UART_Write(&UART_Port1, buf, len)
+#define UART1_Read(buf, len, timeout)   UART_Read(&UART_Port1, buf, len, timeout)
+#define UART1_WaitRx(timeout)           UART_WaitRx(&UART_Port1, timeout)
+#define UART1_WaitTx()                  UART_WaitTx(&UART_Port1)
+#define UART2_Write(buf, len)           UART_Write(&UART_Port2, buf, len)
+#define UART2_Read(buf, len, timeout)   UART_Read(&UART_Port2, buf, len, timeout)
+#define UART2_WaitRx(timeout)           UART_WaitRx(&UART_Port2, timeout)
+#define UART2_WaitTx()                  UART_WaitTx(&UART_Port2)
+#define UART3_Write(buf, len)           UART_Write(&UART_Port3, buf, len)
+#define UART3_Read(buf, len, timeout)   UART_Read(&UART_Port3, buf, len, timeout)
+#define UART3_WaitRx(timeout)           UART_WaitRx(&UART_Port3, timeout)
+#define UART3_WaitTx()                  UART_WaitTx(&UART_Port3)
+#define UART4_Write(buf, len)           UART_Write(&UART_Port4, buf, len)
+#define UART4_Read(buf, len, timeout)   UART_Read(&UART_Port4, buf, len, timeout)
+#define UART4_WaitRx(timeout)           UART_WaitRx(&UART_Port4, timeout)
+#define UART4_WaitTx()                  UART_WaitTx(&UART_Port4)
+#endif
+#define UART1_BufInit()                 UART_BufInit(&UART_Port1)
+#define UART1_ReadDone()                UART_ReadDone(&UART_Port1)
+#define UART2_BufInit()                 UART_BufInit(&UART_Port2)
+#define UART2_ReadDone()                UART_ReadDone(&UART_Port2)
+#define UART3_BufInit()                 UART_BufInit(&UART_Port3)
+#define UART3_ReadDone()                UART_ReadDone(&UART_Port3)
+#define UART4_BufInit()                 UART_BufInit(&UART_Port4)
+#define UART4_ReadDone()                UART_ReadDone(&UART_Port4)
+#endif
@@ -31,6 +31,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm8s.h"
+#include "inc/stm8s_baud.h"
 
 /** @addtogroup STM8S_StdPeriph_Driver
   * @{
@@ -346,6 +347,15 @@ void UART1_DeInit(void);
 void UART1_Init(uint32_t BaudRate, UART1_WordLength_TypeDef WordLength, 
                 UART1_StopBits_TypeDef StopBits, UART1_Parity_TypeDef Parity, 
                 UART1_SyncMode_TypeDef SyncMode, UART1_Mode_TypeDef Mode);
+#if defined(F_CPU) && defined(UART1_BAUD)
+void UART1_InitConst(UART1_WordLength_TypeDef WordLength,
+                     UART1_StopBits_TypeDef StopBits,
+                     UART1_Parity_TypeDef Parity,
+                     UART1_SyncMode_TypeDef SyncMode, UART1_Mode_TypeDef Mode);
+#endif
+#ifdef CLK_ChangeClock_Def
+void UART1_ClockHook(uint32_t fmaster);
+#endif
 void UART1_Cmd(FunctionalState NewState);
 void UART1_ITConfig(UART1_IT_TypeDef UART1_IT, FunctionalState NewState);
 void UART1_HalfDuplexCmd(FunctionalState NewState);
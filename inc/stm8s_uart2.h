@@ -32,6 +32,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "inc/stm8s_clk.h"
 #include "stm8s.h"
+#include "inc/stm8s_baud.h"
 
 /** @addtogroup STM8S_StdPeriph_Driver
   * @{
@@ -406,6 +407,15 @@ void UART2_DeInit(void);
 void UART2_Init(uint32_t BaudRate, UART2_WordLength_TypeDef WordLength, 
                 UART2_StopBits_TypeDef StopBits, UART2_Parity_TypeDef Parity, 
                 UART2_SyncMode_TypeDef SyncMode, UART2_Mode_TypeDef Mode);
+#if defined(F_CPU) && defined(UART2_BAUD)
+void UART2_InitConst(UART2_WordLength_TypeDef WordLength,
+                     UART2_StopBits_TypeDef StopBits,
+                     UART2_Parity_TypeDef Parity,
+                     UART2_SyncMode_TypeDef SyncMode, UART2_Mode_TypeDef Mode);
+#endif
+#ifdef CLK_ChangeClock_Def
+void UART2_ClockHook(uint32_t fmaster);
+#endif
 void UART2_Cmd(FunctionalState NewState);
 void UART2_ITConfig(UART2_IT_TypeDef UART2_IT, FunctionalState NewState);
 void UART2_HalfDuplexCmd(FunctionalState NewState);
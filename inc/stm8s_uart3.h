@@ -31,6 +31,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm8s.h"
+#include "inc/stm8s_baud.h"
 
 /** @addtogroup STM8S_StdPeriph_Driver
   * @{
@@ -356,6 +357,14 @@ void UART3_DeInit(void);
 void UART3_Init(uint32_t BaudRate, UART3_WordLength_TypeDef WordLength, 
                 UART3_StopBits_TypeDef StopBits, UART3_Parity_TypeDef Parity, 
                 UART3_Mode_TypeDef Mode);
+#if defined(F_CPU) && defined(UART3_BAUD)
+void UART3_InitConst(UART3_WordLength_TypeDef WordLength,
+                     UART3_StopBits_TypeDef StopBits,
+                     UART3_Parity_TypeDef Parity, UART3_Mode_TypeDef Mode);
+#endif
+#ifdef CLK_ChangeClock_Def
+void UART3_ClockHook(uint32_t fmaster);
+#endif
 void UART3_Cmd(FunctionalState NewState);
 void UART3_ITConfig(UART3_IT_TypeDef UART3_IT, FunctionalState NewState);
 void UART3_LINBreakDetectionConfig(UART3_LINBreakDetectionLength_TypeDef UART3_LINBreakDetectionLength);
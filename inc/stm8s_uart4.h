@@ -31,6 +31,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm8s.h"
+#include "inc/stm8s_baud.h"
 
 /** @addtogroup STM8S_StdPeriph_Driver
   * @{
@@ -402,6 +403,15 @@ void UART4_DeInit(void);
 void UART4_Init(uint32_t BaudRate, UART4_WordLength_TypeDef WordLength, 
                 UART4_StopBits_TypeDef StopBits, UART4_Parity_TypeDef Parity, 
                 UART4_SyncMode_TypeDef SyncMode, UART4_Mode_TypeDef Mode);
+#if defined(F_CPU) && defined(UART4_BAUD)
+void UART4_InitConst(UART4_WordLength_TypeDef WordLength,
+                     UART4_StopBits_TypeDef StopBits,
+                     UART4_Parity_TypeDef Parity,
+                     UART4_SyncMode_TypeDef SyncMode, UART4_Mode_TypeDef Mode);
+#endif
+#ifdef CLK_ChangeClock_Def
+void UART4_ClockHook(uint32_t fmaster);
+#endif
 void UART4_Cmd(FunctionalState NewState);
 void UART4_ITConfig(UART4_IT_TypeDef UART4_IT, FunctionalState NewState);
 void UART4_HalfDuplexCmd(FunctionalState NewState);
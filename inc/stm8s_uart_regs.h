@@ -0,0 +1,50 @@
+/*
+Registers of UART1..UART4 (layout of SR..CR4 and bits are the same in all
+of them) for drivers which take UART by number: buffered engine, LIN,
+Modbus. Only declarations: including this header does not enable any of
+these drivers.
+*/
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_UART_REGS_H
+#define __STM8S_UART_REGS_H
+
+#include "stm8s.h"
+
+typedef struct
+{
+	__IO uint8_t SR;
+	__IO uint8_t DR;
+	__IO uint8_t BRR1;
+	__IO uint8_t BRR2;
+	__IO uint8_t CR1;
+	__IO uint8_t CR2;
+	__IO uint8_t CR3;
+	__IO uint8_t CR4;
+} UART_Regs_TypeDef;
+
+#define UART_SR_TXE     ((uint8_t)0x80)
+#define UART_SR_TC      ((uint8_t)0x40)
+#define UART_SR_RXNE    ((uint8_t)0x20)
+#define UART_SR_IDLE    ((uint8_t)0x10)
+#define UART_SR_OR      ((uint8_t)0x08)
+#define UART_SR_NF      ((uint8_t)0x04)
+#define UART_SR_FE      ((uint8_t)0x02)
+#define UART_SR_PE      ((uint8_t)0x01)
+#define UART_CR1_R8     ((uint8_t)0x80)
+#define UART_CR1_T8     ((uint8_t)0x40)
+#define UART_CR1_M      ((uint8_t)0x10)
+#define UART_CR1_WAKE   ((uint8_t)0x08)
+#define UART_CR1_PCEN   ((uint8_t)0x04)
+#define UART_CR1_PS     ((uint8_t)0x02)
+#define UART_CR2_TIEN   ((uint8_t)0x80)
+#define UART_CR2_TCIEN  ((uint8_t)0x40)
+#define UART_CR2_RIEN   ((uint8_t)0x20)
+#define UART_CR2_ILIEN  ((uint8_t)0x10)
+#define UART_CR2_TEN    ((uint8_t)0x08)
+#define UART_CR2_REN    ((uint8_t)0x04)
+#define UART_CR2_RWU    ((uint8_t)0x02)
+#define UART_CR2_SBK    ((uint8_t)0x01)
+#define UART_CR3_STOP2  ((uint8_t)0x20)
+#define UART_CR4_ADD    ((uint8_t)0x0F)
+
+#endif
@@ -0,0 +1,464 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_mbuf.c
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Functions for reference counted message buffers
+ *                  This file directly included in osa.c
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_MBUF)
+//------------------------------------------------------------------------------
+
+/*
+ *  Services of task level call these functions with disabled interrupts
+ *  (when OS_ENABLE_INT_QUEUE defined). _I services have own copies of them
+ *  (calling _OS_Queue_Send_I): functions called from interrupts must not be
+ *  shared with tasks on ports with non-reentrant call graph (PIC).
+ */
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Mbuf_Pool_Create (OST_MBUF_POOL *pPool, OST_UINT8 *pBuffer,        *
+ *                             OST_UINT16 BlockSize, OST_UINT Count)            *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Mbuf_Pool_Create)                                *
+ *                                                                              *
+ *                  Splits buffer into Count blocks and links them into list    *
+ *                  of free blocks.                                             *
+ *                                                                              *
+ *  parameters:     pPool       - pointer to pool descriptor                    *
+ *                  pBuffer     - memory of OS_MBUF_POOL_SIZE(BlockSize, Count) *
+ *                                bytes                                         *
+ *                  BlockSize   - size of one buffer (without header)           *
+ *                  Count       - number of buffers                             *
+ *                                                                              *
+ *  on return:      none                                                        *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mbuf_Pool_Create_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mbuf_Pool_Create (OST_MBUF_POOL *pPool, OST_UINT8 *pBuffer,
+                               OST_UINT16 BlockSize, OST_UINT Count)
+    {
+        OST_MBUF_HDR *hdr;
+
+        pPool->pFree = 0;
+        pPool->cFree = Count;
+
+        BlockSize += sizeof(OST_MBUF_HDR);
+
+        while (Count)
+        {
+            Count--;
+            hdr = (OST_MBUF_HDR*)(pBuffer + (OST_UINT16)Count * BlockSize);
+            hdr->pLink = pPool->pFree;
+            hdr->cRefs = 0;
+            pPool->pFree = hdr;
+        }
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mbuf_Pool_Create_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  OST_MSG _OS_Mbuf_Alloc (OST_MBUF_POOL *pPool)                               *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  services OS_Msg_Alloc and OS_Msg_Alloc_Wait)                *
+ *                                                                              *
+ *                  Takes first block from list of free blocks and sets its     *
+ *                  reference counter to 1.                                     *
+ *                                                                              *
+ *  parameters:     pPool       - pointer to pool descriptor                    *
+ *                                                                              *
+ *  on return:      pointer to buffer body or 0 if pool is empty                *
+ *                  OS_IsEventError() return 1, if pool is empty                *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mbuf_Alloc_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_MSG _OS_Mbuf_Alloc (OST_MBUF_POOL *pPool)
+    {
+        OST_MBUF_HDR *hdr;
+
+        _OS_Flags.bEventError = 0;
+
+        hdr = pPool->pFree;
+        if (!hdr)
+        {
+            _OS_Flags.bEventError = 1;
+            return (OST_MSG)0;
+        }
+
+        pPool->pFree = (OST_MBUF_HDR*)hdr->pLink;
+        pPool->cFree--;
+
+        hdr->pLink = pPool;         // Allocated block points to its pool
+        hdr->cRefs = 1;
+
+        return (OST_MSG)(hdr + 1);
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mbuf_Alloc_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Mbuf_Release (OST_MSG Msg)                                         *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Msg_Release)                                     *
+ *                                                                              *
+ *                  Decrements reference counter of buffer. When counter        *
+ *                  becomes zero, returns block into its pool.                  *
+ *                                                                              *
+ *  parameters:     Msg         - pointer to buffer body                        *
+ *                                                                              *
+ *  on return:      none                                                        *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mbuf_Release_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mbuf_Release (OST_MSG Msg)
+    {
+        OST_MBUF_HDR  *hdr;
+        OST_MBUF_POOL *pool;
+
+        hdr = __OS_MBUF_HDR(Msg);
+
+        if (--hdr->cRefs) return;
+
+        pool = (OST_MBUF_POOL*)hdr->pLink;
+        hdr->pLink = pool->pFree;
+        pool->pFree = hdr;
+        pool->cFree++;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mbuf_Release_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Mbuf_Post (OST_QUEUE *pQueue, OST_MSG Msg)                         *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Msg_Post)                                        *
+ *                                                                              *
+ *                  Adds buffer into queue and increments its reference counter.*
+ *                  If queue is full, nothing is done.                          *
+ *                                                                              *
+ *  parameters:     pQueue      - pointer to queue descriptor                   *
+ *                  Msg         - pointer to buffer body                        *
+ *                                                                              *
+ *  on return:      OS_IsEventError() return 1, if queue is full                *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mbuf_Post_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mbuf_Post (OST_QUEUE *pQueue, OST_MSG Msg)
+    {
+        if (__OS_Queue_IsFull(*pQueue))
+        {
+            _OS_Flags.bEventError = 1;
+            return;
+        }
+
+        __OS_MBUF_HDR(Msg)->cRefs++;
+        _OS_Queue_Send(pQueue, Msg);
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mbuf_Post_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  OST_UINT _OS_Mbuf_Multicast (OST_MSG Msg, OST_QUEUE * const *pQueues,       *
+ *                               OST_UINT Count)                                *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Msg_Multicast)                                   *
+ *                                                                              *
+ *                  Posts buffer into every not full queue of list, then drops  *
+ *                  sender's reference. If buffer was not posted anywhere, it   *
+ *                  returns into pool.                                          *
+ *                                                                              *
+ *  parameters:     Msg         - pointer to buffer body                        *
+ *                  pQueues     - array of pointers to queue descriptors        *
+ *                  Count       - number of items in pQueues                    *
+ *                                                                              *
+ *  on return:      number of queues buffer was posted to                       *
+ *                  OS_IsEventError() return 1, if some queue was full          *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mbuf_Multicast_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_UINT _OS_Mbuf_Multicast (OST_MSG Msg, OST_QUEUE * const *pQueues, OST_UINT Count)
+    {
+        OST_UINT    posted = 0;
+        OST_UINT8   error = 0;
+
+        while (Count--)
+        {
+            _OS_Mbuf_Post(*pQueues++, Msg);
+            if (_OS_Flags.bEventError) error = 1;
+            else posted++;
+        }
+
+        _OS_Mbuf_Release(Msg);
+
+        _OS_Flags.bEventError = error;
+        return posted;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mbuf_Multicast_DEFINED)
+//------------------------------------------------------------------------------
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  OST_BOOL _OS_Mbuf_Alloc_Try (OST_MBUF_POOL *pPool, OST_MSG *pMsg)           *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Msg_Alloc_Wait)                                  *
+ *                                                                              *
+ *                  Condition of waiting: tries to allocate buffer with         *
+ *                  disabled interrupts.                                        *
+ *                                                                              *
+ *  parameters:     pPool       - pointer to pool descriptor                    *
+ *                  pMsg        - where to put pointer to buffer body           *
+ *                                                                              *
+ *  on return:      1 if buffer is allocated                                    *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mbuf_Alloc_Try_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_BOOL _OS_Mbuf_Alloc_Try (OST_MBUF_POOL *pPool, OST_MSG *pMsg)
+    {
+        __OS_MBUF_DI();
+        *pMsg = _OS_Mbuf_Alloc(pPool);
+        __OS_MBUF_RI();
+        return *pMsg != 0;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mbuf_Alloc_Try_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  _I copies of functions: OST_MSG _OS_Mbuf_Alloc_I (OST_MBUF_POOL *pPool)     *
+ *                          void _OS_Mbuf_Release_I (OST_MSG Msg)               *
+ *                          void _OS_Mbuf_Post_I (OST_QUEUE *pQueue,            *
+ *                                                OST_MSG Msg)                  *
+ *                          OST_UINT _OS_Mbuf_Multicast_I (OST_MSG Msg,         *
+ *                                   OST_QUEUE * const *pQueues, OST_UINT Count)*
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal functions called by system kernel througth        *
+ *                  services OS_Msg_Alloc_I, OS_Msg_Release_I, OS_Msg_Post_I    *
+ *                  and OS_Msg_Multicast_I)                                     *
+ *                                                                              *
+ *                  Same as functions of task level, called from interrupt.     *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Mbuf_Alloc_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_MSG _OS_Mbuf_Alloc_I (OST_MBUF_POOL *pPool)
+    {
+        OST_MBUF_HDR *hdr;
+
+        _OS_Flags.bEventError = 0;
+
+        hdr = pPool->pFree;
+        if (!hdr)
+        {
+            _OS_Flags.bEventError = 1;
+            return (OST_MSG)0;
+        }
+
+        pPool->pFree = (OST_MBUF_HDR*)hdr->pLink;
+        pPool->cFree--;
+
+        hdr->pLink = pPool;
+        hdr->cRefs = 1;
+
+        return (OST_MSG)(hdr + 1);
+    }
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_INT_QUEUE && !defined(_OS_Mbuf_Alloc_I_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Mbuf_Release_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mbuf_Release_I (OST_MSG Msg)
+    {
+        OST_MBUF_HDR  *hdr;
+        OST_MBUF_POOL *pool;
+
+        hdr = __OS_MBUF_HDR(Msg);
+
+        if (--hdr->cRefs) return;
+
+        pool = (OST_MBUF_POOL*)hdr->pLink;
+        hdr->pLink = pool->pFree;
+        pool->pFree = hdr;
+        pool->cFree++;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_INT_QUEUE && !defined(_OS_Mbuf_Release_I_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Mbuf_Post_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mbuf_Post_I (OST_QUEUE *pQueue, OST_MSG Msg)
+    {
+        if (__OS_Queue_IsFull(*pQueue))
+        {
+            _OS_Flags.bEventError = 1;
+            return;
+        }
+
+        __OS_MBUF_HDR(Msg)->cRefs++;
+        _OS_Queue_Send_I(pQueue, Msg);
+    }
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_INT_QUEUE && !defined(_OS_Mbuf_Post_I_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Mbuf_Multicast_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_UINT _OS_Mbuf_Multicast_I (OST_MSG Msg, OST_QUEUE * const *pQueues, OST_UINT Count)
+    {
+        OST_UINT    posted = 0;
+        OST_UINT8   error = 0;
+
+        while (Count--)
+        {
+            _OS_Mbuf_Post_I(*pQueues++, Msg);
+            if (_OS_Flags.bEventError) error = 1;
+            else posted++;
+        }
+
+        _OS_Mbuf_Release_I(Msg);
+
+        _OS_Flags.bEventError = error;
+        return posted;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_INT_QUEUE && !defined(_OS_Mbuf_Multicast_I_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_MBUF
+//------------------------------------------------------------------------------
+//******************************************************************************
+//  END OF FILE osa_mbuf.c
+//******************************************************************************
@@ -0,0 +1,227 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_mbuf.h
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Reference counted message buffers allocated from fixed-block
+ *                  pool. One buffer can be posted into several queues of
+ *                  pointers to messages at once.
+ *                  This file directly included in osa.h
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+/************************************************************************************************
+ *                                                                                              *
+ *                     R E F E R E N C E   C O U N T E D   B U F F E R S                        *
+ *                                                                                              *
+ ************************************************************************************************/
+
+/*
+ *  Every block of pool is preceded by header OST_MBUF_HDR. While block is free
+ *  header links it into list of free blocks; while block is allocated header
+ *  points to pool owner and holds number of references. Allocation and
+ *  releasing take constant time.
+ *
+ *      OST_UINT8       can_buf[OS_MBUF_POOL_SIZE(sizeof(T_CAN_FRAME), 6)];
+ *      OST_MBUF_POOL   can_pool;
+ *      OST_QUEUE       *can_dest[3] = {&q_logger, &q_proto, &q_wdt};
+ *
+ *      OS_Mbuf_Pool_Create(can_pool, can_buf, sizeof(T_CAN_FRAME), 6);
+ *
+ *      // Interrupt:
+ *      OS_Msg_Alloc_I(can_pool, frame);            // frame is (T_CAN_FRAME*)
+ *      if (frame) {
+ *          ...                                     // fill frame
+ *          OS_Msg_Multicast_I(frame, can_dest, 3);
+ *      }
+ *
+ *      // Each receiver task:
+ *      OS_Queue_Wait(q_logger, frame);
+ *      ...
+ *      OS_Msg_Release(frame);
+ *
+ *  After allocation buffer has one reference owned by sender. OS_Msg_Post adds
+ *  one reference per queue; OS_Msg_Multicast posts buffer into list of queues
+ *  and then drops sender's reference (sender must not touch buffer after it).
+ *  Buffer returns into pool when last reference is released.
+ *
+ *  Post and Multicast never push messages out of full queue (pushed out
+ *  buffer would never be released). Full queues are skipped and
+ *  OS_IsEventError() returns 1.
+ *
+ */
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+
+//******************************************************************************
+//  FUNCTION PROTOTYPES
+//******************************************************************************
+
+
+//******************************************************************************
+//  MACROS
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_MBUF
+//------------------------------------------------------------------------------
+
+// Buffers are posted from interrupts together with queues (OS_ENABLE_INT_QUEUE)
+
+#if defined(OS_ENABLE_INT_QUEUE)
+
+    #define __OS_MBUF_DI()       _OS_DI_INT()
+    #define __OS_MBUF_RI()       _OS_RI_INT()
+
+#else
+
+    #define __OS_MBUF_DI()
+    #define __OS_MBUF_RI()
+
+#endif
+
+
+extern void     _OS_Mbuf_Pool_Create (OST_MBUF_POOL *pPool, OST_UINT8 *pBuffer,
+                                      OST_UINT16 BlockSize, OST_UINT Count);
+extern OST_MSG  _OS_Mbuf_Alloc       (OST_MBUF_POOL *pPool);
+extern void     _OS_Mbuf_Release     (OST_MSG Msg);
+extern void     _OS_Mbuf_Post        (OST_QUEUE *pQueue, OST_MSG Msg);
+extern OST_UINT _OS_Mbuf_Multicast   (OST_MSG Msg, OST_QUEUE * const *pQueues, OST_UINT Count);
+extern OST_BOOL _OS_Mbuf_Alloc_Try   (OST_MBUF_POOL *pPool, OST_MSG *pMsg);
+
+
+//------------------------------------------------------------------------------
+// Size of memory (in bytes) for pool of "count" blocks of "block_size" bytes
+
+#define OS_MBUF_POOL_SIZE(block_size, count)    ((count) * (sizeof(OST_MBUF_HDR) + (block_size)))
+
+// Header of allocated buffer
+#define __OS_MBUF_HDR(msg)           (((OST_MBUF_HDR*)(msg)) - 1)
+
+
+//------------------------------------------------------------------------------
+// Create pool and link all blocks into list of free blocks
+
+#define OS_Mbuf_Pool_Create(pool, buffer, block_size, count)                \
+    OSM_BEGIN {                                                             \
+        __OS_MBUF_DI();                                                     \
+        _OS_Mbuf_Pool_Create(&(pool), (OST_UINT8*)(buffer), block_size, count);\
+        __OS_MBUF_RI();                                                     \
+    } OSM_END
+
+// Number of free blocks in pool
+#define OS_Mbuf_Pool_Free(pool)      ((pool).cFree)
+
+// Number of references to buffer
+#define OS_Msg_RefCount(msg)         (__OS_MBUF_HDR(msg)->cRefs)
+
+
+//------------------------------------------------------------------------------
+// Allocate buffer. If pool is empty then msg_var = 0 and OS_IsEventError() return 1
+
+#define OS_Msg_Alloc(pool, msg_var)                                         \
+    OSM_BEGIN {                                                             \
+        __OS_MBUF_DI();                                                     \
+        *(OST_MSG*)&(msg_var) = _OS_Mbuf_Alloc(&(pool));                    \
+        __OS_MBUF_RI();                                                     \
+    } OSM_END
+
+// Wait for free block in pool and allocate it. Allocation is tried on every
+// check of condition, so block taken by interrupt between check and
+// allocation does not leave msg_var = 0.
+
+#define OS_Msg_Alloc_Wait(pool, msg_var)                                    \
+    OS_Wait(_OS_Mbuf_Alloc_Try(&(pool), (OST_MSG*)&(msg_var)))
+
+
+//------------------------------------------------------------------------------
+// Add one reference to buffer (e.g. before giving it to another consumer)
+
+#define OS_Msg_AddRef(msg)                                                  \
+    OSM_BEGIN {                                                             \
+        __OS_MBUF_DI();                                                     \
+        __OS_MBUF_HDR(msg)->cRefs++;                                        \
+        __OS_MBUF_RI();                                                     \
+    } OSM_END
+
+// Drop one reference. Buffer returns into pool when last reference dropped.
+
+#define OS_Msg_Release(msg)                                                 \
+    OSM_BEGIN {                                                             \
+        __OS_MBUF_DI();                                                     \
+        _OS_Mbuf_Release(OST_CONVERT_TYPE_MSG(msg));                        \
+        __OS_MBUF_RI();                                                     \
+    } OSM_END
+
+
+//------------------------------------------------------------------------------
+// Post buffer into queue adding one reference. Full queue is not touched.
+
+#define OS_Msg_Post(queue, msg)                                             \
+    OSM_BEGIN {                                                             \
+        __OS_MBUF_DI();                                                     \
+        _OS_Mbuf_Post(&(queue), OST_CONVERT_TYPE_MSG(msg));                 \
+        __OS_MBUF_RI();                                                     \
+    } OSM_END
+
+// Post buffer into list of queues and drop sender's reference.
+// Number of queues message was posted to is returned in _OS_Temp.
+
+#define OS_Msg_Multicast(msg, queue_list, count)                            \
+    OSM_BEGIN {                                                             \
+        __OS_MBUF_DI();                                                     \
+        _OS_Temp = _OS_Mbuf_Multicast(OST_CONVERT_TYPE_MSG(msg), queue_list, count);\
+        __OS_MBUF_RI();                                                     \
+    } OSM_END
+
+
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE)
+//------------------------------------------------------------------------------
+
+    extern OST_MSG  _OS_Mbuf_Alloc_I     (OST_MBUF_POOL *pPool);
+    extern void     _OS_Mbuf_Release_I   (OST_MSG Msg);
+    extern void     _OS_Mbuf_Post_I      (OST_QUEUE *pQueue, OST_MSG Msg);
+    extern OST_UINT _OS_Mbuf_Multicast_I (OST_MSG Msg, OST_QUEUE * const *pQueues, OST_UINT Count);
+
+    #define OS_Msg_Alloc_I(pool, msg_var)       *(OST_MSG*)&(msg_var) = _OS_Mbuf_Alloc_I(&(pool))
+    #define OS_Msg_AddRef_I(msg)                __OS_MBUF_HDR(msg)->cRefs++
+    #define OS_Msg_Release_I(msg)               _OS_Mbuf_Release_I(OST_CONVERT_TYPE_MSG(msg))
+    #define OS_Msg_Post_I(queue, msg)           _OS_Mbuf_Post_I(&(queue), OST_CONVERT_TYPE_MSG(msg))
+    #define OS_Msg_Multicast_I(msg, queue_list, count)                      \
+                                                _OS_Mbuf_Multicast_I(OST_CONVERT_TYPE_MSG(msg), queue_list, count)
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------
+#endif      // OS_ENABLE_MBUF
+//------------------------------------------------------------------------------
+
+
+//******************************************************************************
+//  END OF FILE osa_mbuf.h
+//******************************************************************************
@@ -0,0 +1,326 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_xqueue.c
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Functions for queues of messages copied by value
+ *                  This file directly included in osa.c
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+
+
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_XQUEUE)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Copy one element. On STM8 (no alignment restrictions) most usual sizes
+// (2 and 4 bytes) are copied by single load/store; other ports may trap on
+// unaligned word access (PIC24), so they copy by byte loop only.
+// Made as macro (not function) so that _I copies of functions stay
+// independent from functions called from tasks.
+
+#define __OS_XQUEUE_COPY_BYTES(dst, src, size)                              \
+    OSM_BEGIN {                                                             \
+        OST_UINT8       *_d = (OST_UINT8*)(dst);                            \
+        const OST_UINT8 *_s = (const OST_UINT8*)(src);                      \
+        OST_UINT         _n = size;                                         \
+        do *_d++ = *_s++; while (--_n);                                     \
+    } OSM_END
+
+#if defined(__OSA_STM8__)
+
+#define __OS_XQUEUE_COPY(dst, src, size)                                    \
+    OSM_BEGIN {                                                             \
+        switch (size)                                                       \
+        {                                                                   \
+            case 1:                                                         \
+                *(OST_UINT8*)(dst) = *(const OST_UINT8*)(src);              \
+                break;                                                      \
+            case 2:                                                         \
+                *(OST_UINT16*)(dst) = *(const OST_UINT16*)(src);            \
+                break;                                                      \
+            case 4:                                                         \
+                *(OST_UINT32*)(dst) = *(const OST_UINT32*)(src);            \
+                break;                                                      \
+            default:                                                        \
+                __OS_XQUEUE_COPY_BYTES(dst, src, size);                     \
+                break;                                                      \
+        }                                                                   \
+    } OSM_END
+
+#else
+
+#define __OS_XQUEUE_COPY(dst, src, size)    __OS_XQUEUE_COPY_BYTES(dst, src, size)
+
+#endif
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Xqueue_Send (OST_XQUEUE *pQueue, const void *pElem)                *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Xqueue_Send)                                     *
+ *                                                                              *
+ *                  Copies message into queue. Replaces first message if there  *
+ *                  is no free room to add new message. Service OS_Xqueue_Send  *
+ *                  before adding new message checks for free room. Thus        *
+ *                  messages will not deleted accidentally.                     *
+ *                                                                              *
+ *                                                                              *
+ *  parameters:     pQueue      - pointer to queue descriptor                   *
+ *                  pElem       - pointer to message to be copied               *
+ *                                                                              *
+ *  on return:      OS_IsEventError() return 1, if first message was pushed out *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Xqueue_Send_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Xqueue_Send (OST_XQUEUE *pQueue, const void *pElem)
+    {
+
+        OST_QUEUE_CONTROL   q;
+        OST_UINT16 temp;
+
+        q = pQueue->Q;
+        _OS_Flags.bEventError = 0;
+
+        //------------------------------------------------------
+        // If there is no free room in queue, then replace
+        // first message in queue by new one
+
+        if (q.cSize == q.cFilled)
+        {
+            temp = q.cBegin;
+            q.cBegin++;
+            if (q.cBegin == q.cSize) q.cBegin = 0;
+
+            _OS_Flags.bEventError = 1;
+        }
+        else
+        {
+            //------------------------------------------------------
+            // There is a free room in queue.
+            // Add new message at end of queue.
+
+            temp = (OST_UINT16)q.cBegin + q.cFilled;
+            if (temp >= q.cSize) temp -= q.cSize;
+            q.cFilled++;
+        }
+
+        __OS_XQUEUE_COPY(pQueue->pData + temp * pQueue->cElemSize, pElem, pQueue->cElemSize);
+
+        pQueue->Q = q;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Xqueue_Send_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+
+
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Xqueue_Send_I (OST_XQUEUE *pQueue, const void *pElem)              *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    Copy of _OS_Xqueue_Send to be called from interrupt         *
+ *                                                                              *
+ *  parameters:     pQueue      - pointer to queue descriptor                   *
+ *                  pElem       - pointer to message to be copied               *
+ *                                                                              *
+ *  on return:      OS_IsEventError() return 1, if first message was pushed out *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Xqueue_Send_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Xqueue_Send_I (OST_XQUEUE *pQueue, const void *pElem)
+    {
+
+        OST_QUEUE_CONTROL   q;
+        OST_UINT16 temp;
+
+        q = pQueue->Q;
+        _OS_Flags.bEventError = 0;
+
+        if (q.cSize == q.cFilled)
+        {
+            temp = q.cBegin;
+            q.cBegin++;
+            if (q.cBegin == q.cSize) q.cBegin = 0;
+
+            _OS_Flags.bEventError = 1;
+        }
+        else
+        {
+            temp = (OST_UINT16)q.cBegin + q.cFilled;
+            if (temp >= q.cSize) temp -= q.cSize;
+            q.cFilled++;
+        }
+
+        __OS_XQUEUE_COPY(pQueue->pData + temp * pQueue->cElemSize, pElem, pQueue->cElemSize);
+
+        pQueue->Q = q;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // (OS_ENABLE_INT_QUEUE) && !defined(_OS_Xqueue_Send_I_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+
+
+
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Xqueue_Get (OST_XQUEUE *pQueue, void *pElem)                       *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Xqueue_Accept)                                   *
+ *                                                                              *
+ *                  Copy first message from queue. Before calling this function *
+ *                  be sure that queue is not empty (OS_Xqueue_Accept does it   *
+ *                  automatically). After execution this function first message *
+ *                  will be deleted from queue.                                 *
+ *                                                                              *
+ *  parameters:     pQueue      - pointer to queue descriptor                   *
+ *                  pElem       - where to copy message (0 - just delete it)    *
+ *                                                                              *
+ *  on return:      none                                                        *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Xqueue_Get_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Xqueue_Get (OST_XQUEUE *pQueue, void *pElem)
+    {
+        OST_QUEUE_CONTROL   q;
+        OST_UINT            temp;
+
+
+        q = pQueue->Q;
+        temp = q.cBegin;
+        q.cBegin++;
+
+        if (q.cBegin >= q.cSize)    q.cBegin = 0;
+
+        q.cFilled--;
+
+        if (pElem)
+            __OS_XQUEUE_COPY(pElem, pQueue->pData + temp * pQueue->cElemSize, pQueue->cElemSize);
+
+        pQueue->Q = q;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Xqueue_Get_DEFINED)
+//------------------------------------------------------------------------------
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Xqueue_Get_I (OST_XQUEUE *pQueue, void *pElem)                     *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    Copy of _OS_Xqueue_Get to be called from interrupt          *
+ *                  (service OS_Xqueue_Accept_I)                                *
+ *                                                                              *
+ *  parameters:     pQueue      - pointer to queue descriptor                   *
+ *                  pElem       - where to copy message (0 - just delete it)    *
+ *                                                                              *
+ *  on return:      none                                                        *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Xqueue_Get_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Xqueue_Get_I (OST_XQUEUE *pQueue, void *pElem)
+    {
+        OST_QUEUE_CONTROL   q;
+        OST_UINT temp;
+
+        q = pQueue->Q;
+        temp = q.cBegin;
+        q.cBegin++;
+
+        if (q.cBegin >= q.cSize)    q.cBegin = 0;
+
+        q.cFilled--;
+
+        if (pElem)
+            __OS_XQUEUE_COPY(pElem, pQueue->pData + temp * pQueue->cElemSize, pQueue->cElemSize);
+
+        pQueue->Q = q;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // defined(OS_ENABLE_INT_QUEUE) && !defined(_OS_Xqueue_Get_I_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_XQUEUE
+//------------------------------------------------------------------------------
+//******************************************************************************
+//  END OF FILE osa_xqueue.c
+//******************************************************************************
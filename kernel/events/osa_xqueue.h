@@ -0,0 +1,309 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_xqueue.h
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Services for work with queue of messages copied by value
+ *                  (element size is set when queue is created)
+ *                  This file directly included in osa.h
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+/************************************************************************************************
+ *                                                                                              *
+ *                    Q U E U E   O F   M E S S A G E S   B Y   V A L U E                       *
+ *                                                                                              *
+ ************************************************************************************************/
+
+/*
+ *  Unlike OST_QUEUE (which holds pointers to message bodies that must stay
+ *  alive until receiver accepts them) xqueue holds copies of messages. Sender
+ *  may reuse its variable (e.g. local struct in ISR) immediately after sending.
+ *
+ *  Buffer must have room for (count * elem_size) bytes:
+ *
+ *      typedef struct { OST_UINT8 cmd; OST_UINT16 arg; } T_CMD;
+ *
+ *      T_CMD       cmd_buf[8];
+ *      OST_XQUEUE  cmd_queue;
+ *      ...
+ *      OS_Xqueue_Create(cmd_queue, cmd_buf, sizeof(T_CMD), 8);
+ *      ...
+ *      OS_Xqueue_Send(cmd_queue, cmd);     // cmd is T_CMD variable
+ *      OS_Xqueue_Wait(cmd_queue, cmd);     // cmd is T_CMD variable
+ *
+ *  Second parameter of Send/Accept/Wait services must be lvalue: its address
+ *  is taken to copy elem_size bytes to/from queue buffer. Elements of 1, 2
+ *  and 4 bytes are copied by single load/store, others - by byte loop.
+ *
+ */
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+
+//******************************************************************************
+//  FUNCTION PROTOTYPES
+//******************************************************************************
+
+
+//******************************************************************************
+//  MACROS
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_XQUEUE
+//------------------------------------------------------------------------------
+
+// Interrupt guards are shared with queue of pointers (OS_ENABLE_INT_QUEUE)
+
+#if defined(OS_ENABLE_INT_QUEUE)
+
+    #define __OS_XQUEUE_DI()      _OS_DI_INT()
+    #define __OS_XQUEUE_RI()      _OS_RI_INT()
+
+#else
+
+    #define __OS_XQUEUE_DI()
+    #define __OS_XQUEUE_RI()
+
+#endif
+
+
+extern void     _OS_Xqueue_Send (OST_XQUEUE *pQueue, const void *pElem);
+extern void     _OS_Xqueue_Get  (OST_XQUEUE *pQueue, void *pElem);
+
+
+//------------------------------------------------------------------------------
+// Create queue
+
+#define OS_Xqueue_Create(queue, buffer, elem_size, count)    \
+    OSM_BEGIN {                                          \
+        __OS_XQUEUE_DI();                                \
+        (queue).Q.cSize = count;                         \
+        (queue).Q.cBegin = 0;                            \
+        (queue).Q.cFilled = 0;                           \
+        (queue).pData = (OST_UINT8*)(buffer);            \
+        (queue).cElemSize = elem_size;                   \
+        __OS_XQUEUE_RI();                                \
+    } OSM_END
+
+
+// Internal macros
+
+#define __OS_Xqueue_IsFull(queue)    ((queue).Q.cFilled == (queue).Q.cSize)
+#define __OS_Xqueue_Check(queue)     ((queue).Q.cFilled)
+
+
+// Check for any message present in queue
+#define OS_Xqueue_Check(queue)       __OS_Xqueue_Check(queue)
+
+// Clear queue
+#define OS_Xqueue_Clear(queue)       (queue).Q.cFilled = 0
+
+
+
+//------------------------------------------------------------------------------
+// Send message via queue. If queue is full then most rearly message will be pushed out.
+
+#define OS_Xqueue_Send_Now(queue, elem)                                 \
+    OSM_BEGIN {                                                         \
+        __OS_XQUEUE_DI();                                               \
+        _OS_Xqueue_Send(&(queue), &(elem));                             \
+        __OS_XQUEUE_RI();                                               \
+    } OSM_END
+
+
+#define __OS_Xqueue_Accept(queue, elem)                                 \
+    OSM_BEGIN {                                                         \
+        _OS_Xqueue_Get(&(queue), &(elem));                              \
+    } OSM_END
+
+
+#define OS_Xqueue_Accept(queue, elem)                                   \
+    OSM_BEGIN {                                                         \
+        __OS_XQUEUE_DI();                                               \
+        __OS_Xqueue_Accept(queue, elem);                                \
+        __OS_XQUEUE_RI();                                               \
+    } OSM_END
+
+
+#define OS_Xqueue_Delete(queue)                                         \
+    OSM_BEGIN {                                                         \
+        __OS_XQUEUE_DI();                                               \
+        _OS_Xqueue_Get(&(queue), 0);                                    \
+        __OS_XQUEUE_RI();                                               \
+    } OSM_END
+
+
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_QUEUE)
+//------------------------------------------------------------------------------
+
+
+    extern void     _OS_Xqueue_Send_I (OST_XQUEUE *pQueue, const void *pElem);
+    extern void     _OS_Xqueue_Get_I  (OST_XQUEUE *pQueue, void *pElem);
+
+    #define OS_Xqueue_Send_I(queue, elem)       _OS_Xqueue_Send_I(&(queue), &(elem))
+    #define OS_Xqueue_Accept_I(queue, elem)     _OS_Xqueue_Get_I(&(queue), &(elem))
+    #define OS_Xqueue_Check_I(queue)            __OS_Xqueue_Check(queue)
+    #define OS_Xqueue_Clear_I(queue)            OS_Xqueue_Clear(queue)
+    #define OS_Xqueue_IsFull_I(queue)           __OS_Xqueue_IsFull(queue)
+    #define OS_Xqueue_Delete_I(queue)           _OS_Xqueue_Get_I(&(queue), 0)
+
+    //------------------------------------------------------------------------------
+    // Wait message from queue. After accepting message will be deleted from queue.
+
+    #define OS_Xqueue_Wait(queue, elem)                                     \
+        OSM_BEGIN {                                                         \
+            for (;;) {                                                      \
+                OS_Wait(__OS_Xqueue_Check(queue));                          \
+                __OS_XQUEUE_DI();                                           \
+                if (__OS_Xqueue_Check(queue)) break;                        \
+                __OS_XQUEUE_RI();                                           \
+            }                                                               \
+            __OS_Xqueue_Accept(queue, elem);                                \
+            __OS_XQUEUE_RI();                                               \
+        } OSM_END
+
+    //------------------------------------------------------------------------------
+    // Wait message from queue. After accepting message will be deleted from queue. Exit if timeout expired.
+
+    #define OS_Xqueue_Wait_TO(queue, elem, timeout)                         \
+        OSM_BEGIN {                                                         \
+            for (;;) {                                                      \
+                OS_Wait_TO(__OS_Xqueue_Check(queue), timeout);              \
+                __OS_XQUEUE_DI();                                           \
+                if (__OS_Xqueue_Check(queue) || OS_IsTimeout()) break;      \
+                __OS_XQUEUE_RI();                                           \
+            }                                                               \
+            if (!OS_IsTimeout()) __OS_Xqueue_Accept(queue, elem);           \
+            __OS_XQUEUE_RI();                                               \
+        } OSM_END
+
+    // Send message via queue. If queue full then wait for free place
+
+    #define OS_Xqueue_Send(queue, elem)                                     \
+        OSM_BEGIN {                                                         \
+            __OS_XQUEUE_DI();                                               \
+            while (__OS_Xqueue_IsFull(queue))                               \
+            {                                                               \
+                __OS_XQUEUE_RI();                                           \
+                OS_Wait(!__OS_Xqueue_IsFull(queue));                        \
+                __OS_XQUEUE_DI();                                           \
+            }                                                               \
+            _OS_Xqueue_Send(&(queue), &(elem));                             \
+            __OS_XQUEUE_RI();                                               \
+        } OSM_END
+
+
+    //------------------------------------------------------------------------------
+    // Send message via queue. If queue full then wait for free place. Exit if timeout expired.
+
+    #define OS_Xqueue_Send_TO(queue, elem, timeout)                         \
+        OSM_BEGIN {                                                         \
+            _OS_Flags.bTimeout = 0;                                         \
+            __OS_XQUEUE_DI();                                               \
+            while (__OS_Xqueue_IsFull(queue) && !OS_IsTimeout())            \
+            {                                                               \
+                __OS_XQUEUE_RI();                                           \
+                OS_Wait_TO(!__OS_Xqueue_IsFull(queue), timeout);            \
+                __OS_XQUEUE_DI();                                           \
+            }                                                               \
+            if (!OS_IsTimeout()) {                                          \
+                _OS_Xqueue_Send(&(queue), &(elem));                         \
+            }                                                               \
+            __OS_XQUEUE_RI();                                               \
+        } OSM_END
+
+
+    // Check for queue is full
+
+    #define OS_Xqueue_IsFull(queue)  (__OS_XQUEUE_DI(),_OS_Temp = __OS_Xqueue_IsFull(queue),__OS_XQUEUE_RI(),_OS_Temp)
+
+
+
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+
+    //------------------------------------------------------------------------------
+    // Wait message from queue. After accepting message will be deleted from queue.
+
+    #define OS_Xqueue_Wait(queue, elem)                                     \
+        OSM_BEGIN {                                                         \
+            OS_Wait(__OS_Xqueue_Check(queue));                              \
+            __OS_Xqueue_Accept(queue, elem);                                \
+        } OSM_END
+
+    //------------------------------------------------------------------------------
+    // Wait message from queue. After accepting message will be deleted from queue. Exit if timeout expired.
+
+    #define OS_Xqueue_Wait_TO(queue, elem, timeout)                         \
+        OSM_BEGIN {                                                         \
+            OS_Wait_TO(__OS_Xqueue_Check(queue), timeout);                  \
+            if (!OS_IsTimeout()) __OS_Xqueue_Accept(queue, elem);           \
+        } OSM_END
+
+    // Send message via queue. If queue full then wait for free place
+
+    #define OS_Xqueue_Send(queue, elem)                                     \
+        OSM_BEGIN {                                                         \
+            if (__OS_Xqueue_IsFull(queue))                                  \
+            {                                                               \
+                OS_Wait(!__OS_Xqueue_IsFull(queue));                        \
+            }                                                               \
+            _OS_Xqueue_Send(&(queue), &(elem));                             \
+        } OSM_END
+
+
+    //------------------------------------------------------------------------------
+    // Send message via queue. If queue full then wait for free place. Exit if timeout expired.
+
+    #define OS_Xqueue_Send_TO(queue, elem, timeout)                         \
+        OSM_BEGIN {                                                         \
+            _OS_Flags.bTimeout = 0;                                         \
+            if (__OS_Xqueue_IsFull(queue))                                  \
+            {                                                               \
+                OS_Wait_TO(!__OS_Xqueue_IsFull(queue), timeout);            \
+            }                                                               \
+            if (!OS_IsTimeout()) {                                          \
+                _OS_Xqueue_Send(&(queue), &(elem));                         \
+            }                                                               \
+        } OSM_END
+
+    // Check for queue is full
+    #define OS_Xqueue_IsFull(queue)  __OS_Xqueue_IsFull(queue)
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------
+#endif      // OS_ENABLE_XQUEUE
+//------------------------------------------------------------------------------
+
+
+//******************************************************************************
+//  END OF FILE osa_xqueue.h
+//******************************************************************************
@@ -0,0 +1,207 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_mtask.c
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Micro-tasks functions and host task
+ *                  This file directly included in osa.c
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_MTASKS)
+//------------------------------------------------------------------------------
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+         OST_MTASK       _OS_Mtasks[OS_MTASKS];
+         OST_MTASK_FUNC  _OS_Mtask_Funcs[OS_MTASKS];
+volatile OST_UINT8       _OS_Mtask_Ticks;           // Incremented by OS_Timer
+
+static   OST_UINT8       _OS_Mtask_Last;            // Ticks at last pass
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Mtask_Create (OST_MTASK_FUNC pFunc)                                *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  service OS_Mtask_Create)                                    *
+ *                                                                              *
+ *                  Takes free slot of micro-tasks table and starts micro-task  *
+ *                  from beginning.                                             *
+ *                                                                              *
+ *  parameters:     pFunc       - micro-task function (OS_MTASK)                *
+ *                                                                              *
+ *  on return:      OS_IsError() return 1, if there is no free slot             *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mtask_Create_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mtask_Create (OST_MTASK_FUNC pFunc)
+    {
+        OST_UINT i;
+
+        _OS_Flags.bError = 0;
+
+        for (i = 0; i < OS_MTASKS; i++)
+        {
+            if (_OS_Mtask_Funcs[i]) continue;
+
+            _OS_Mtasks[i].Lc = 0;
+            _OS_Mtasks[i].Timer = 0;
+            _OS_Mtask_Funcs[i] = pFunc;
+            return;
+        }
+
+        _OS_Flags.bError = 1;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mtask_Create_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  OST_UINT8 _OS_Mtask_Pass (void)                                             *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by host task)                     *
+ *                                                                              *
+ *                  Decrements timers of micro-tasks by number of ticks passed  *
+ *                  since last pass and calls every micro-task once.            *
+ *                                                                              *
+ *  parameters:     none                                                        *
+ *                                                                              *
+ *  on return:      1 - some micro-task waits for event (host must poll)        *
+ *                  0 - all micro-tasks wait for timers only                    *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mtask_Pass_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_UINT8 _OS_Mtask_Pass (void)
+    {
+        OST_UINT    i;
+        OST_UINT8   elapsed;
+        OST_UINT8   poll = 0;
+        OST_MTASK  *mt;
+
+        elapsed = _OS_Mtask_Ticks - _OS_Mtask_Last;
+        _OS_Mtask_Last += elapsed;
+
+        mt = _OS_Mtasks;
+        for (i = 0; i < OS_MTASKS; i++, mt++)
+        {
+            if (!_OS_Mtask_Funcs[i]) continue;
+
+            if (mt->Timer > elapsed) mt->Timer -= elapsed;
+            else mt->Timer = 0;
+
+            switch (_OS_Mtask_Funcs[i](mt))
+            {
+                case OS_MT_WAITING:
+                    poll = 1;
+                    break;
+                case OS_MT_ENDED:
+                    _OS_Mtask_Funcs[i] = 0;
+                    break;
+            }
+        }
+
+        return poll;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mtask_Pass_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Mtask_Task (void)                                                  *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    Host task (created by OS_Mtask_Host_Create). Runs passes    *
+ *                  of micro-tasks. When all micro-tasks wait for timers only,  *
+ *                  host sleeps till next system tick.                          *
+ *                                                                              *
+ *  parameters:     none                                                        *
+ *                                                                              *
+ *  on return:      none                                                        *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Mtask_Task_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Mtask_Task (void)
+    {
+        _OS_Mtask_Last = _OS_Mtask_Ticks;
+
+        for (;;)
+        {
+            if (_OS_Mtask_Pass())
+            {
+                OS_Yield();
+            }
+            else
+            {
+                OS_Wait(_OS_Mtask_Ticks != _OS_Mtask_Last);
+            }
+        }
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Mtask_Task_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_MTASKS
+//------------------------------------------------------------------------------
+//******************************************************************************
+//  END OF FILE osa_mtask.c
+//******************************************************************************
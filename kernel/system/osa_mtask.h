@@ -0,0 +1,197 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_mtask.h
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Micro-tasks: small state machines (protothreads) executed
+ *                  by one OSA task.
+ *                  This file directly included in osa.h
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+
+/************************************************************************************************
+ *                                                                                              *
+ *                                 M I C R O - T A S K S                                        *
+ *                                                                                              *
+ ************************************************************************************************/
+
+/*
+ *  Configuration (OSAcfg.h):
+ *
+ *      OS_ENABLE_MTASKS        - enable micro-tasks
+ *      OS_MTASKS               - max number of micro-tasks (default 8)
+ *      OS_MTIMER_SIZE          - size of micro-task timer: 1 or 2 (default 2)
+ *      OS_MTASK_PRIORITY       - priority of host task (default 7 - lowest)
+ *
+ *  Micro-task keeps only its continuation (line number of last wait point,
+ *  2 bytes) and timer (1 or 2 bytes) in RAM, plus pointer to its function.
+ *  All micro-tasks are executed by one host task, which takes one OST_TCB.
+ *
+ *      OS_MTASK(Blink)
+ *      {
+ *          OS_Mt_Begin();
+ *          for (;;) {
+ *              PORTE ^= 0x20;
+ *              OS_Mt_Delay(500);
+ *          }
+ *          OS_Mt_End();
+ *      }
+ *
+ *      void main (void)
+ *      {
+ *          OS_Init();
+ *          OS_Mtask_Host_Create();
+ *          OS_Mtask_Create(Blink);
+ *          ...
+ *
+ *  Restrictions (usual for protothreads):
+ *      - local variables are not kept between waits, use static ones;
+ *      - services OS_Mt_xxx can not be used inside "switch" statement and
+ *        only one of them can be placed in one source line;
+ *      - micro-task must not call OSA services that switch context
+ *        (OS_Wait, OS_Delay, OS_Yield ...), use OS_Mt_xxx instead.
+ *
+ */
+
+//******************************************************************************
+//  CONFIGURATION
+//******************************************************************************
+
+#ifndef OS_MTASKS
+    #define OS_MTASKS           8
+#endif
+
+#ifndef OS_MTASK_PRIORITY
+    #define OS_MTASK_PRIORITY   OS_WORST_PRIORITY
+#endif
+
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+extern          OST_MTASK       _OS_Mtasks[OS_MTASKS];
+extern          OST_MTASK_FUNC  _OS_Mtask_Funcs[OS_MTASKS];
+extern volatile OST_UINT8       _OS_Mtask_Ticks;
+
+
+//******************************************************************************
+//  FUNCTION PROTOTYPES
+//******************************************************************************
+
+extern void      _OS_Mtask_Create (OST_MTASK_FUNC pFunc);
+extern OST_UINT8 _OS_Mtask_Pass   (void);
+extern void      _OS_Mtask_Task   (void);
+
+
+//******************************************************************************
+//  MACROS
+//******************************************************************************
+
+// Values returned by micro-task function
+
+#define OS_MT_WAITING       0       // Waits for event (must be polled)
+#define OS_MT_DELAYED       1       // Waits for timer only
+#define OS_MT_ENDED         2       // Finished, slot is free
+
+
+//------------------------------------------------------------------------------
+// Create host task and micro-tasks
+
+#define OS_Mtask_Host_Create()      OS_Task_Create(OS_MTASK_PRIORITY, _OS_Mtask_Task)
+
+// If there is no free slot then OS_IsError() returns 1
+#define OS_Mtask_Create(func)       _OS_Mtask_Create(func)
+
+// Stop micro-task by its function
+#define OS_Mtask_Delete(func)                                               \
+    OSM_BEGIN {                                                             \
+        for (_OS_Temp = 0; _OS_Temp < OS_MTASKS; _OS_Temp++)                \
+            if (_OS_Mtask_Funcs[_OS_Temp] == (func))                        \
+                _OS_Mtask_Funcs[_OS_Temp] = 0;                              \
+    } OSM_END
+
+
+//------------------------------------------------------------------------------
+// Definition of micro-task function
+
+#define OS_MTASK(name)              OST_UINT8 name (OST_MTASK *_mt)
+
+
+//------------------------------------------------------------------------------
+// Body of micro-task
+
+#define OS_Mt_Begin()               switch (_mt->Lc) { case 0:
+
+#define OS_Mt_End()                 } _mt->Lc = 0; return OS_MT_ENDED
+
+
+// Internal: save continuation and set point to return to
+
+#define __OS_Mt_Set()               _mt->Lc = __LINE__; case __LINE__:
+
+
+//------------------------------------------------------------------------------
+// Return to host, continue from this point next time
+
+#define OS_Mt_Yield()                                                       \
+    OSM_BEGIN {                                                             \
+        _mt->Lc = __LINE__; return OS_MT_WAITING; case __LINE__:;           \
+    } OSM_END
+
+// Wait for condition
+
+#define OS_Mt_Wait(event)                                                   \
+    OSM_BEGIN {                                                             \
+        __OS_Mt_Set();                                                      \
+        if (!(event)) return OS_MT_WAITING;                                 \
+    } OSM_END
+
+// Delay micro-task for given number of system ticks
+
+#define OS_Mt_Delay(delaytime)                                              \
+    OSM_BEGIN {                                                             \
+        _mt->Timer = (delaytime);                                           \
+        __OS_Mt_Set();                                                      \
+        if (_mt->Timer) return OS_MT_DELAYED;                               \
+    } OSM_END
+
+// Wait for condition. Exit if timeout expired (check by OS_Mt_IsTimeout())
+
+#define OS_Mt_Wait_TO(event, timeout)                                       \
+    OSM_BEGIN {                                                             \
+        _mt->Timer = (timeout);                                             \
+        __OS_Mt_Set();                                                      \
+        if (event) _mt->Timer = 1;                                          \
+        else if (_mt->Timer) return OS_MT_WAITING;                          \
+    } OSM_END
+
+#define OS_Mt_IsTimeout()           (!_mt->Timer)
+
+// Start micro-task from beginning on next pass
+#define OS_Mt_Restart()             OSM_BEGIN { _mt->Lc = 0; return OS_MT_WAITING; } OSM_END
+
+// Finish micro-task and free its slot
+#define OS_Mt_Exit()                OSM_BEGIN { _mt->Lc = 0; return OS_MT_ENDED; } OSM_END
+
+
+
+//******************************************************************************
+//  END OF FILE osa_mtask.h
+//******************************************************************************
@@ -82,6 +82,14 @@ void OS_Init (void)
 
     #endif
 
+    #ifdef OS_ENABLE_TIME32
+        _OS_Time32 = 0;
+    #endif
+
+    #ifdef OS_ENABLE_TIMER_DEFER
+        _OS_Timer_Pending = 0;
+    #endif
+
 
 
     /*--------------------------------------*
@@ -308,7 +316,7 @@ void OS_Init (void)
      *                                      *
      *--------------------------------------*/
 
-    #if OS_TASKS > 10
+    #if OS_TASKS > 32
         _OS_SET_IRP_CUR_TASK();
         _OS_CurTask = (OST_TASK_POINTER) _OS_Tasks;
         _OS_Temp = OS_TASKS;
@@ -361,6 +369,135 @@ void OS_Init (void)
            _OS_Tasks[9].State.bEnable = 0;
         #endif
 
+        #if OS_TASKS > 10
+           _OS_Tasks[10].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 11
+           _OS_Tasks[11].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 12
+           _OS_Tasks[12].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 13
+           _OS_Tasks[13].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 14
+           _OS_Tasks[14].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 15
+           _OS_Tasks[15].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 16
+           _OS_Tasks[16].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 17
+           _OS_Tasks[17].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 18
+           _OS_Tasks[18].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 19
+           _OS_Tasks[19].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 20
+           _OS_Tasks[20].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 21
+           _OS_Tasks[21].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 22
+           _OS_Tasks[22].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 23
+           _OS_Tasks[23].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 24
+           _OS_Tasks[24].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 25
+           _OS_Tasks[25].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 26
+           _OS_Tasks[26].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 27
+           _OS_Tasks[27].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 28
+           _OS_Tasks[28].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 29
+           _OS_Tasks[29].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 30
+           _OS_Tasks[30].State.bEnable = 0;
+        #endif
+
+        #if OS_TASKS > 31
+           _OS_Tasks[31].State.bEnable = 0;
+        #endif
+
+    #endif
+
+
+    /*--------------------------------------*
+     *                                      *
+     *  Make all task descriptors free      *
+     *                                      *
+     *--------------------------------------*/
+
+    #if defined(_OS_TASKS_FREE_MAP)
+
+        #if OS_TASKS > 4*_OST_INT_SIZE
+
+            _OS_Temp = sizeof(_OS_TasksFree) / sizeof(OST_WORD);
+            do
+            {
+                _OS_TasksFree[_OS_Temp-1] = (OST_WORD)-1;
+            } while (--_OS_Temp);
+
+        #else
+            #if OS_TASKS >= 1*_OST_INT_SIZE
+                _OS_TasksFree[0] = (OST_WORD)-1;
+            #endif
+
+            #if OS_TASKS >= 2*_OST_INT_SIZE
+                _OS_TasksFree[1] = (OST_WORD)-1;
+            #endif
+
+            #if OS_TASKS >= 3*_OST_INT_SIZE
+                _OS_TasksFree[2] = (OST_WORD)-1;
+            #endif
+
+            #if OS_TASKS >= 4*_OST_INT_SIZE
+                _OS_TasksFree[3] = (OST_WORD)-1;
+            #endif
+        #endif
+
+        #if (OS_TASKS & _OST_INT_MASK) != 0
+        _OS_TasksFree[OS_TASKS >> _OST_INT_SHIFT] = (1 << (OS_TASKS & _OST_INT_MASK)) - 1;
+        #endif
+
     #endif
 
 
@@ -563,7 +700,7 @@ void OS_Init (void)
 
 //-----------------------------------------------------------------
 #ifdef OS_ENABLE_OS_TIMER
-#ifndef OS_USE_INLINE_TIMER
+#if !defined(OS_USE_INLINE_TIMER) && !defined(OS_ENABLE_TIMER_DEFER)
 //-----------------------------------------------------------------
 void OS_Timer (void)
 {
@@ -576,6 +713,89 @@ void OS_Timer (void)
 
 
 
+/*
+ ********************************************************************************
+ *
+ *   void _OS_Timer_Defer (void)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    (Internal function called by OS_Sched)
+ *
+ *                  Do timers work for all ticks counted by OS_Timer since
+ *                  last call. Interrupts are enabled during the work.
+ *
+ *  parameters:     none
+ *
+ *  on return:      none
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//-----------------------------------------------------------------
+#if defined(OS_ENABLE_OS_TIMER) && defined(OS_ENABLE_TIMER_DEFER)
+//-----------------------------------------------------------------
+void _OS_Timer_Defer (void)
+{
+    char temp;
+
+    while (_OS_Timer_Pending)
+    {
+        temp = OS_DI();
+        _OS_Timer_Pending--;
+        OS_RI(temp);
+
+        __OS_TimerInline();
+    }
+}
+//-----------------------------------------------------------------
+#endif  // OS_ENABLE_TIMER_DEFER
+//-----------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *
+ *   OST_UINT32 OS_GetTime32 (void)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    Get number of system ticks since OS_Init. Counter is
+ *                  incremented by OS_Timer and read with disabled interrupts
+ *                  (32-bit read is not atomic on 8-bit controllers).
+ *
+ *  parameters:     none
+ *
+ *  on return:      32-bit ticks counter
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//-----------------------------------------------------------------
+#ifdef OS_ENABLE_TIME32
+//-----------------------------------------------------------------
+OST_UINT32 OS_GetTime32 (void)
+{
+    OST_UINT32 time;
+    char temp;
+
+    temp = OS_DI();
+    time = _OS_Time32;
+    OS_RI(temp);
+
+    return time;
+}
+//-----------------------------------------------------------------
+#endif  // OS_ENABLE_TIME32
+//-----------------------------------------------------------------
+
+
+
 
 
 
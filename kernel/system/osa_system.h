@@ -52,6 +52,13 @@ extern void  OS_Init (void);
 extern void OS_EnterCriticalSection (void);
 extern void OS_LeaveCriticalSection (void);
 
+//------------------------------------------------------------------------------
+// 32-bit counter of system ticks
+#ifdef OS_ENABLE_TIME32
+extern volatile OS_BANK OST_UINT32 _OS_Time32;
+extern OST_UINT32 OS_GetTime32 (void);
+#endif
+
 
 
 
@@ -154,6 +161,7 @@ extern void OS_LeaveCriticalSection (void);
 
     #define OS_Sched()                                                                          \
     {                                                                                           \
+        __OS_SCHED_TIMER_WORK();                                                                \
                                                                                                 \
         /* First we suppose that there is no ready task*/                                       \
         _OS_Flags.bBestTaskFound = 0;                                                           \
@@ -292,6 +300,7 @@ extern void OS_LeaveCriticalSection (void);
 
     #define OS_Sched()                                                                          \
     {                                                                                           \
+        __OS_SCHED_TIMER_WORK();                                                                \
                                                                                                 \
         /* First we suppose that there is no ready task*/                                       \
         _OS_Flags.bBestTaskFound = 0;                                                           \
@@ -417,6 +426,7 @@ extern void OS_LeaveCriticalSection (void);
 
     #define OS_Sched()                                                                          \
     {                                                                                           \
+        __OS_SCHED_TIMER_WORK();                                                                \
         _OS_Temp = 0;                                                                           \
                                                                                                 \
         _OS_IF_NOT_IN_CRITICAL_SECTION()                                                        \
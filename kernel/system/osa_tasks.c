@@ -35,6 +35,10 @@
 
 OS_TASKS_BANK  OST_TCB  _OS_Tasks[OS_TASKS] OS_ALLOCATION_TASKS;
 
+#if defined(_OS_TASKS_FREE_MAP)
+OS_TASKS_BANK  OST_WORD _OS_TasksFree[(OS_TASKS + _OST_INT_SIZE-1) / _OST_INT_SIZE];
+#endif
+
 #if (OS_BANK_TASKS == 0) && defined(__OSA_PIC18_MPLABC__)
 #pragma udata
 #endif
@@ -52,6 +56,11 @@ OS_TASKS_BANK  OST_TCB  _OS_Tasks[OS_TASKS] OS_ALLOCATION_TASKS;
  *   description:   (Internal function called by system kernel from service
  *                  OS_Task_Create)
  *                  Create task in free descriptor.
+ *
+ *                  When _OS_TASKS_FREE_MAP is defined free descriptor is taken
+ *                  from bitmap _OS_TasksFree: first word with set bit, then
+ *                  first set bit in it by table of nibbles. Time does not
+ *                  depend on number of busy descriptors.
  *  parameters:     priority - value from 0 (highest) to 7 (lowest)
  *                  TaskAddr - pointer to C-function that contains task
  *
@@ -72,69 +81,107 @@ OS_TASKS_BANK  OST_TCB  _OS_Tasks[OS_TASKS] OS_ALLOCATION_TASKS;
 #if !defined(_OS_Task_Create_DEFINED)
 //------------------------------------------------------------------------------
 
+    #if defined(_OS_TASKS_FREE_MAP)
+    // Number of lowest set bit in nibble
+    static const OST_UINT8 _OS_FirstSetBit[16] = {0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0};
+    #endif
+
     void _OS_Task_Create(OST_WORD priority, OST_CODE_POINTER TaskAddr)
     {
         OST_TASK_POINTER Task;
 
+        #if defined(_OS_TASKS_FREE_MAP)
+        OST_UINT n;
+        OST_WORD temp;
+        #endif
+
         _OS_Flags.bError = 0;
 
 
+        #if defined(_OS_TASKS_FREE_MAP)
+
         /*--------------------------------------*
          *                                      *
-         *  Start search from first task in     *
-         *  OS_TASKS descriptors.               *
+         *  Take first free descriptor from     *
+         *  bitmap.                             *
          *                                      *
          *--------------------------------------*/
-        Task = (OST_TASK_POINTER)_OS_Tasks;
-        _OS_Temp = 0;   
-
-        do {
+        n = 0;
+        while (!(temp = _OS_TasksFree[n]))
+        {
+            if (++n >= sizeof(_OS_TasksFree) / sizeof(OST_WORD))
+            {
+                // There is no free descriptor. Task was not created.
+                _OS_Flags.bError = 1;
+                return ;
+            }
+        }
 
-            if (!Task->State.bEnable)               // Is descriptor free?
-            {                                       // Yes
-                ((OST_TASK_STATE*)&priority)->bEnable = 1;
-                ((OST_TASK_STATE*)&priority)->bReady = 1;
+        _OS_Temp = n << _OST_INT_SHIFT;
+        while (!(temp & 0x0F))
+        {
+            temp >>= 4;
+            _OS_Temp += 4;
+        }
+        _OS_Temp += _OS_FirstSetBit[temp & 0x0F];
 
-                Task->pTaskPointer = TaskAddr;
+        _OS_TasksFree[n] &= ~(1 << (_OS_Temp & _OST_INT_MASK));
+        Task = (OST_TASK_POINTER)_OS_Tasks + _OS_Temp;
 
-                #ifdef OS_ENABLE_TTIMERS
-                    Task->Timer = 0;
-                #endif
+        #else
 
-                #ifdef _OS_TASK_CREATE_PROC_SPEC
-                _OS_TASK_CREATE_PROC_SPEC();
-                #endif
+        /*--------------------------------------*
+         *                                      *
+         *  Start search from first task in     *
+         *  OS_TASKS descriptors.               *
+         *                                      *
+         *--------------------------------------*/
+        Task = (OST_TASK_POINTER)_OS_Tasks;
+        _OS_Temp = 0;   
 
-                *((OS_TASKS_BANK char*)&Task->State) = priority;
+        while (Task->State.bEnable)                 // Is descriptor free?
+        {
+            Task ++;
+            if (++_OS_Temp >= OS_TASKS)
+            {
+                // There is no free descriptor. Task was not created.
+                _OS_Flags.bError = 1;
+                return ;
+            }
+        }
 
-                #if defined(_OS_CUR_FLAGS_IN_OS_STATE)
-                if (Task == _OS_CurTask) *((OS_RAM_NEAR char*)&_OS_State) = priority;
-                #endif
+        #endif
 
-                #if defined(__OSA_AVR_WINAVR__) || defined(__OSA_AVR_IAR__)
-                Task->nY_Temp = 0x8000;
-                #endif
+        ((OST_TASK_STATE*)&priority)->bEnable = 1;
+        ((OST_TASK_STATE*)&priority)->bReady = 1;
 
-                #if defined(__OSA_AVR_WINAVR__)
-                Task->c_NumOfTemp = 0;  
-                #endif
+        Task->pTaskPointer = TaskAddr;
 
-                #if defined(__OSA_STM8__)
-                Task->nSP_Temp = 0;
-                #endif
+        #ifdef OS_ENABLE_TTIMERS
+            Task->Timer = 0;
+        #endif
 
-                _OS_Flags.bError = 0;
+        #ifdef _OS_TASK_CREATE_PROC_SPEC
+        _OS_TASK_CREATE_PROC_SPEC();
+        #endif
 
-                return ;
+        *((OS_TASKS_BANK char*)&Task->State) = priority;
 
-            }
+        #if defined(_OS_CUR_FLAGS_IN_OS_STATE)
+        if (Task == _OS_CurTask) *((OS_RAM_NEAR char*)&_OS_State) = priority;
+        #endif
 
-            Task ++;
+        #if defined(__OSA_AVR_WINAVR__) || defined(__OSA_AVR_IAR__)
+        Task->nY_Temp = 0x8000;
+        #endif
 
-        } while (++_OS_Temp < OS_TASKS);    
+        #if defined(__OSA_AVR_WINAVR__)
+        Task->c_NumOfTemp = 0;  
+        #endif
 
-        // There is no free descriptor. Task was not created.
-        _OS_Flags.bError = 1;
+        #if defined(__OSA_STM8__)
+        Task->nSP_Temp = 0;
+        #endif
 
         return ;
     }
@@ -37,6 +37,19 @@
 extern OS_TASKS_BANK    OST_TCB  _OS_Tasks[OS_TASKS];
 
 
+//------------------------------------------------------------------------------
+// Free descriptors are found through bitmap (1 - descriptor is free). Ports
+// that overload _OS_Task_Create keep their own linear search.
+
+#if (defined(__OSA_STM8__) || defined(__OSA_AVR__)) && !defined(OS_DISABLE_TASKS_FREE_MAP)
+    #define _OS_TASKS_FREE_MAP
+#endif
+
+#if defined(_OS_TASKS_FREE_MAP)
+extern OS_TASKS_BANK    OST_WORD _OS_TasksFree[(OS_TASKS + _OST_INT_SIZE-1) / _OST_INT_SIZE];
+#endif
+
+
 //******************************************************************************
 //  FUNCTION PROTOTYPES
 //******************************************************************************
@@ -110,6 +123,25 @@ void _OS_Task_Create(OST_UINT priority, OST_CODE_POINTER TaskAddr);
 
 #define this_task   _OS_CurTask
 
+
+//------------------------------------------------------------------------------
+// Return descriptor into bitmap of free descriptors
+
+#if defined(_OS_TASKS_FREE_MAP)
+
+    #define __OS_TASK_SET_FREE(pTask)                                       \
+        OSM_BEGIN {                                                         \
+            _OS_Temp = (OST_TASK_POINTER)(pTask) - (OST_TASK_POINTER)_OS_Tasks;\
+            _OS_TASK_ATOMIC_WRITE_A(                                        \
+                _OS_TasksFree[_OS_Temp >> _OST_INT_SHIFT] |= 1 << (_OS_Temp & _OST_INT_MASK));\
+        } OSM_END
+
+#else
+
+    #define __OS_TASK_SET_FREE(pTask)
+
+#endif
+
 /************************************************************************/
 /*                                                                      */
 /* Stop current task                                                    */
@@ -131,6 +163,7 @@ void _OS_Task_Create(OST_UINT priority, OST_CODE_POINTER TaskAddr);
     #define OS_Task_Delete(pTask)                                           \
         {                                                                   \
             _OS_TASK_ATOMIC_WRITE_A(pTask->State.bEnable = 0);              \
+            __OS_TASK_SET_FREE(pTask);                                      \
             if ((pTask) == (_OS_CurTask))                                   \
             {                                                               \
                 __OS_CLEAR_STATE_ENABLE();                                  \
@@ -143,6 +176,7 @@ void _OS_Task_Create(OST_UINT priority, OST_CODE_POINTER TaskAddr);
     #define OS_Task_Delete(pTask)                                           \
         {                                                                   \
             _OS_TASK_ATOMIC_WRITE_A((pTask)->State.bEnable &= ~1);          \
+            __OS_TASK_SET_FREE(pTask);                                      \
             if ((pTask) == (_OS_CurTask))                                   \
             {                                                               \
                 __OS_CLEAR_STATE_ENABLE();                                  \
@@ -156,6 +190,7 @@ void _OS_Task_Create(OST_UINT priority, OST_CODE_POINTER TaskAddr);
         {                                                                   \
             _OS_SET_IRP_CUR_TASK();   /* for mikroC for PIC16 only */       \
             _OS_TASK_ATOMIC_WRITE_A((pTask)->State.bEnable = 0);            \
+            __OS_TASK_SET_FREE(pTask);                                      \
             if ((pTask) == (_OS_CurTask))                                   \
             {                                                               \
                 __OS_CLEAR_STATE_ENABLE();                                  \
@@ -0,0 +1,238 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_work.c
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Deferred work queue functions and worker task
+ *                  This file directly included in osa.c
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_WORK)
+//------------------------------------------------------------------------------
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+volatile OST_QUEUE_CONTROL  _OS_Work_Q;
+         OST_WORK           _OS_Work_Items[OS_WORK_ITEMS];
+
+static   OST_WORK           _OS_Work_Cur;       // Item being executed by worker
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Work_Submit (OST_WORK_FUNC pFunc, void *pArg, OST_UINT8 bOnce)     *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    (Internal function called by system kernel througth         *
+ *                  services OS_Work_Submit and OS_Work_Submit_Once)            *
+ *                                                                              *
+ *                  Adds function call at end of work queue. Is called with     *
+ *                  disabled interrupts.                                        *
+ *                                                                              *
+ *  parameters:     pFunc       - function to be called by worker task          *
+ *                  pArg        - parameter for function                        *
+ *                  bOnce       - 1: do not add item if the same (pFunc, pArg)  *
+ *                                is already waiting in queue                   *
+ *                                                                              *
+ *  on return:      OS_IsEventError() return 1, if queue is full                *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Work_Submit_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Work_Submit (OST_WORK_FUNC pFunc, void *pArg, OST_UINT8 bOnce)
+    {
+        OST_QUEUE_CONTROL   q;
+        OST_UINT            temp;
+        OST_UINT            i;
+
+        q = _OS_Work_Q;
+        _OS_Flags.bEventError = 0;
+
+        //------------------------------------------------------
+        // Look for the same item waiting in queue
+
+        if (bOnce)
+        {
+            temp = q.cBegin;
+            for (i = q.cFilled; i; i--)
+            {
+                if (_OS_Work_Items[temp].pFunc == pFunc &&
+                    _OS_Work_Items[temp].pArg  == pArg) return;
+                if (++temp == OS_WORK_ITEMS) temp = 0;
+            }
+        }
+
+        //------------------------------------------------------
+        // There is no free room in queue: item is lost
+
+        if (q.cFilled == OS_WORK_ITEMS)
+        {
+            _OS_Flags.bEventError = 1;
+            return;
+        }
+
+        temp = q.cBegin + q.cFilled;
+        if (temp >= OS_WORK_ITEMS) temp -= OS_WORK_ITEMS;
+        _OS_Work_Items[temp].pFunc = pFunc;
+        _OS_Work_Items[temp].pArg  = pArg;
+
+        _OS_Work_Q.cFilled = q.cFilled + 1;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Work_Submit_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Work_Submit_I (OST_WORK_FUNC pFunc, void *pArg, OST_UINT8 bOnce)   *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    Copy of _OS_Work_Submit to be called from interrupt         *
+ *                  (services OS_Work_Submit_I and OS_Work_Submit_Once_I)       *
+ *                                                                              *
+ *  parameters:     pFunc       - function to be called by worker task          *
+ *                  pArg        - parameter for function                        *
+ *                  bOnce       - 1: do not add item if the same (pFunc, pArg)  *
+ *                                is already waiting in queue                   *
+ *                                                                              *
+ *  on return:      OS_IsEventError() return 1, if queue is full                *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if defined(OS_ENABLE_INT_WORK) && !defined(_OS_Work_Submit_I_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Work_Submit_I (OST_WORK_FUNC pFunc, void *pArg, OST_UINT8 bOnce)
+    {
+        OST_QUEUE_CONTROL   q;
+        OST_UINT            temp;
+        OST_UINT            i;
+
+        q = _OS_Work_Q;
+        _OS_Flags.bEventError = 0;
+
+        //------------------------------------------------------
+        // Look for the same item waiting in queue
+
+        if (bOnce)
+        {
+            temp = q.cBegin;
+            for (i = q.cFilled; i; i--)
+            {
+                if (_OS_Work_Items[temp].pFunc == pFunc &&
+                    _OS_Work_Items[temp].pArg  == pArg) return;
+                if (++temp == OS_WORK_ITEMS) temp = 0;
+            }
+        }
+
+        //------------------------------------------------------
+        // There is no free room in queue: item is lost
+
+        if (q.cFilled == OS_WORK_ITEMS)
+        {
+            _OS_Flags.bEventError = 1;
+            return;
+        }
+
+        temp = q.cBegin + q.cFilled;
+        if (temp >= OS_WORK_ITEMS) temp -= OS_WORK_ITEMS;
+        _OS_Work_Items[temp].pFunc = pFunc;
+        _OS_Work_Items[temp].pArg  = pArg;
+
+        _OS_Work_Q.cFilled = q.cFilled + 1;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // defined(OS_ENABLE_INT_WORK) && !defined(_OS_Work_Submit_I_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *                                                                              *
+ *  void _OS_Work_Task (void)                                                   *
+ *                                                                              *
+ *------------------------------------------------------------------------------*
+ *                                                                              *
+ *  description:    Worker task (created by OS_Work_Create). Takes items from   *
+ *                  work queue one by one and calls them. Every item is taken   *
+ *                  after OS_Wait, so tasks with higher priority are not        *
+ *                  blocked by long list of work.                               *
+ *                                                                              *
+ *  parameters:     none                                                        *
+ *                                                                              *
+ *  on return:      none                                                        *
+ *                                                                              *
+ *  Overloaded in:  -                                                           *
+ *                                                                              *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Work_Task_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Work_Task (void)
+    {
+        for (;;)
+        {
+            OS_Wait(_OS_Work_Q.cFilled);
+
+            __OS_WORK_DI();
+            _OS_Work_Cur = _OS_Work_Items[_OS_Work_Q.cBegin];
+            if (++_OS_Work_Q.cBegin == OS_WORK_ITEMS) _OS_Work_Q.cBegin = 0;
+            _OS_Work_Q.cFilled--;
+            __OS_WORK_RI();
+
+            _OS_Work_Cur.pFunc(_OS_Work_Cur.pArg);
+        }
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Work_Task_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_WORK
+//------------------------------------------------------------------------------
+//******************************************************************************
+//  END OF FILE osa_work.c
+//******************************************************************************
@@ -0,0 +1,157 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_work.h
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Deferred work queue. Interrupt handler submits function call
+ *                  which is executed later by one system worker task.
+ *                  This file directly included in osa.h
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+
+/************************************************************************************************
+ *                                                                                              *
+ *                           D E F E R R E D   W O R K   Q U E U E                              *
+ *                                                                                              *
+ ************************************************************************************************/
+
+/*
+ *  Configuration (OSAcfg.h):
+ *
+ *      OS_ENABLE_WORK          - enable work queue
+ *      OS_ENABLE_INT_WORK      - enable OS_Work_Submit_I services (or
+ *                                OS_ENABLE_INT_ALL)
+ *      OS_WORK_ITEMS           - size of queue (default 4)
+ *      OS_WORK_PRIORITY        - priority of worker task (default 0 - highest)
+ *
+ *  Worker task takes one descriptor of OS_TASKS. It must be created in main():
+ *
+ *      OS_Init();
+ *      OS_Work_Create();
+ *      ...
+ *
+ *      void I2C_IRQHandler (void)
+ *      {
+ *          ...                                     // short hardware part
+ *          OS_Work_Submit_I(i2c_done, &i2c_data);
+ *      }
+ *
+ *  Function is called as pFunc(pArg) from worker task (not from interrupt),
+ *  so it may be long, but it must not call services that switch context.
+ *
+ *  OS_Work_Submit_Once_I does not add item if the same pair (pFunc, pArg)
+ *  is already waiting in queue (e.g. "buffer has data" events coming faster
+ *  than worker handles them).
+ *
+ *  If queue is full item is lost and OS_IsEventError() returns 1.
+ *
+ */
+
+//******************************************************************************
+//  CONFIGURATION
+//******************************************************************************
+
+#ifndef OS_WORK_ITEMS
+    #define OS_WORK_ITEMS       4
+#endif
+
+#ifndef OS_WORK_PRIORITY
+    #define OS_WORK_PRIORITY    0
+#endif
+
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+extern volatile OST_QUEUE_CONTROL  _OS_Work_Q;
+extern          OST_WORK           _OS_Work_Items[OS_WORK_ITEMS];
+
+
+//******************************************************************************
+//  FUNCTION PROTOTYPES
+//******************************************************************************
+
+extern void     _OS_Work_Submit (OST_WORK_FUNC pFunc, void *pArg, OST_UINT8 bOnce);
+extern void     _OS_Work_Task   (void);
+
+#if defined(OS_ENABLE_INT_WORK)
+extern void     _OS_Work_Submit_I (OST_WORK_FUNC pFunc, void *pArg, OST_UINT8 bOnce);
+#endif
+
+
+//******************************************************************************
+//  MACROS
+//******************************************************************************
+
+#if defined(OS_ENABLE_INT_WORK)
+
+    #define __OS_WORK_DI()      _OS_DI_INT()
+    #define __OS_WORK_RI()      _OS_RI_INT()
+
+#else
+
+    #define __OS_WORK_DI()
+    #define __OS_WORK_RI()
+
+#endif
+
+
+//------------------------------------------------------------------------------
+// Create worker task
+
+#define OS_Work_Create()        OS_Task_Create(OS_WORK_PRIORITY, _OS_Work_Task)
+
+// Number of items waiting in queue
+#define OS_Work_Pending()       (_OS_Work_Q.cFilled)
+
+
+//------------------------------------------------------------------------------
+// Submit function call from interrupt
+
+#if defined(OS_ENABLE_INT_WORK)
+
+    #define OS_Work_Submit_I(func, arg)         _OS_Work_Submit_I(func, (void*)(arg), 0)
+    #define OS_Work_Submit_Once_I(func, arg)    _OS_Work_Submit_I(func, (void*)(arg), 1)
+
+#endif
+
+
+//------------------------------------------------------------------------------
+// Submit function call from task
+
+#define OS_Work_Submit(func, arg)                                           \
+    OSM_BEGIN {                                                             \
+        __OS_WORK_DI();                                                     \
+        _OS_Work_Submit(func, (void*)(arg), 0);                             \
+        __OS_WORK_RI();                                                     \
+    } OSM_END
+
+#define OS_Work_Submit_Once(func, arg)                                      \
+    OSM_BEGIN {                                                             \
+        __OS_WORK_DI();                                                     \
+        _OS_Work_Submit(func, (void*)(arg), 1);                             \
+        __OS_WORK_RI();                                                     \
+    } OSM_END
+
+
+
+//******************************************************************************
+//  END OF FILE osa_work.h
+//******************************************************************************
@@ -0,0 +1,305 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_ctimer.c
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Functions for callback timers and timer service task
+ *                  This file directly included in osa.c
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_CTIMERS
+//------------------------------------------------------------------------------
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+OST_CTIMER * volatile OS_BANK   _OS_Ctimer_List;
+volatile OS_BANK OS_CTIMER_TYPE _OS_Ctimer_Late;
+
+
+
+/*
+ ********************************************************************************
+ *
+ *  void _OS_Ctimer_Stop (OST_CTIMER *pTimer)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    (Internal function called by system kernel througth
+ *                  service OS_Ctimer_Stop)
+ *
+ *                  Remove timer from list. Rest of its time is added to next
+ *                  timer. If first timer is removed, ticks the list is late
+ *                  for (_OS_Ctimer_Late) are moved into new first timer as
+ *                  service task does. Must be called with disabled interrupts.
+ *
+ *  parameters:     pTimer  - pointer to timer
+ *
+ *  on return:      none
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Ctimer_Stop_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Ctimer_Stop (OST_CTIMER *pTimer)
+    {
+        OST_CTIMER * OS_BANK *pp;
+        OST_CTIMER          *next;
+        OS_CTIMER_TYPE      late;
+
+        if (!pTimer->bActive) return;
+        pTimer->bActive = 0;
+
+        pp = (OST_CTIMER * OS_BANK *)&_OS_Ctimer_List;
+        while (*pp)
+        {
+            if (*pp == pTimer)
+            {
+                next = pTimer->pNext;
+                *pp = next;
+                if (next) next->Delta += pTimer->Delta;
+                if (pp != (OST_CTIMER * OS_BANK *)&_OS_Ctimer_List) return;
+
+                //------------------------------------------------------
+                // Head is removed: late ticks go to new head
+
+                if (!next)
+                {
+                    _OS_Ctimer_Late = 0;
+                }
+                else
+                {
+                    late = _OS_Ctimer_Late;
+                    if (late > next->Delta) late = next->Delta;
+                    next->Delta -= late;
+                    _OS_Ctimer_Late -= late;
+                }
+                return;
+            }
+            pp = &(*pp)->pNext;
+        }
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Ctimer_Stop_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *
+ *  void _OS_Ctimer_Insert (OST_CTIMER *pTimer, OS_CTIMER_TYPE Delay)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    (Internal function called by system kernel)
+ *
+ *                  Insert stopped timer into list sorted by expiry time.
+ *                  Timer is placed after all timers expiring in the same
+ *                  tick. Delay is counted from expiry of first timer (list
+ *                  is _OS_Ctimer_Late ticks behind current time).
+ *                  Must be called with disabled interrupts.
+ *
+ *  parameters:     pTimer  - pointer to timer
+ *                  Delay   - time to expiry (in system ticks)
+ *
+ *  on return:      none
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Ctimer_Insert_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Ctimer_Insert (OST_CTIMER *pTimer, OS_CTIMER_TYPE Delay)
+    {
+        OST_CTIMER * OS_BANK *pp;
+
+        pTimer->bActive = 1;
+
+        pp = (OST_CTIMER * OS_BANK *)&_OS_Ctimer_List;
+        while (*pp && (*pp)->Delta <= Delay)
+        {
+            Delay -= (*pp)->Delta;
+            pp = &(*pp)->pNext;
+        }
+
+        pTimer->Delta = Delay;
+        pTimer->pNext = *pp;
+        if (*pp) (*pp)->Delta -= Delay;
+        *pp = pTimer;
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Ctimer_Insert_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *
+ *  void _OS_Ctimer_Start (OST_CTIMER *pTimer, OS_CTIMER_TYPE Delay,
+ *                         OS_CTIMER_TYPE Period)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    (Internal function called by system kernel througth
+ *                  service OS_Ctimer_Start)
+ *
+ *                  Restart timer: Delay is counted from now, so ticks the
+ *                  list is late (_OS_Ctimer_Late) are added to it.
+ *                  Must be called with disabled interrupts.
+ *
+ *  parameters:     pTimer  - pointer to timer
+ *                  Delay   - time to first expiry (in system ticks)
+ *                  Period  - 0 for one-shot timer, reload value otherwise
+ *
+ *  on return:      none
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Ctimer_Start_DEFINED)
+//------------------------------------------------------------------------------
+
+    void _OS_Ctimer_Start (OST_CTIMER *pTimer, OS_CTIMER_TYPE Delay, OS_CTIMER_TYPE Period)
+    {
+        _OS_Ctimer_Stop(pTimer);
+
+        pTimer->Period = Period;
+
+        if (Delay > (OS_CTIMER_TYPE)~_OS_Ctimer_Late) Delay = (OS_CTIMER_TYPE)~0;
+        else Delay += _OS_Ctimer_Late;
+
+        _OS_Ctimer_Insert(pTimer, Delay);
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Ctimer_Start_DEFINED)
+//------------------------------------------------------------------------------
+
+
+
+/*
+ ********************************************************************************
+ *
+ *  void _OS_Ctimer_Task (void)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    Timer service task (created by OS_Ctimer_Service_Create).
+ *
+ *                  Waits for first timer in list to expire. Then takes all
+ *                  expired timers from head of list one by one, restarts
+ *                  auto-reload ones and calls their functions.
+ *
+ *                  Ticks counted by OS_Timer while head was expired
+ *                  (_OS_Ctimer_Late) are moved into delta of first not
+ *                  expired timer before each step, but not further: expiry
+ *                  time of every timer stays exact, so auto-reload timer is
+ *                  restarted from its own expiry time, and timers started
+ *                  meanwhile (by functions) count their delay from now.
+ *
+ *  parameters:     none
+ *
+ *  on return:      none
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Ctimer_Task_DEFINED)
+//------------------------------------------------------------------------------
+
+    static OST_CTIMER   *_OS_Ctimer_Cur;
+
+    void _OS_Ctimer_Task (void)
+    {
+        OS_CTIMER_TYPE  late;
+
+        for (;;)
+        {
+            OS_Wait(_OS_Ctimer_List && !_OS_Ctimer_List->Delta);
+
+            for (;;)
+            {
+                __OS_CTIMER_DI();
+
+                //------------------------------------------------------
+                // Take into account ticks passed after expiry of head
+
+                _OS_Ctimer_Cur = _OS_Ctimer_List;
+                if (!_OS_Ctimer_Cur)
+                {
+                    _OS_Ctimer_Late = 0;
+                }
+                else if (_OS_Ctimer_Cur->Delta)
+                {
+                    late = _OS_Ctimer_Late;
+                    if (late > _OS_Ctimer_Cur->Delta) late = _OS_Ctimer_Cur->Delta;
+                    _OS_Ctimer_Cur->Delta -= late;
+                    _OS_Ctimer_Late -= late;
+                }
+
+                //------------------------------------------------------
+                // Call next expired timer
+
+                if (!_OS_Ctimer_Cur || _OS_Ctimer_Cur->Delta)
+                {
+                    __OS_CTIMER_RI();
+                    break;
+                }
+                _OS_Ctimer_List = _OS_Ctimer_Cur->pNext;
+                _OS_Ctimer_Cur->bActive = 0;
+                if (_OS_Ctimer_Cur->Period)
+                    _OS_Ctimer_Insert(_OS_Ctimer_Cur, _OS_Ctimer_Cur->Period);
+                __OS_CTIMER_RI();
+
+                _OS_Ctimer_Cur->pFunc(_OS_Ctimer_Cur->pArg);
+            }
+        }
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Ctimer_Task_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_CTIMERS
+//------------------------------------------------------------------------------
+//******************************************************************************
+//  END OF FILE osa_ctimer.c
+//******************************************************************************
@@ -0,0 +1,153 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_ctimer.h
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Callback timers: when timer expires, user function is called
+ *                  by timer service task.
+ *                  This file directly included in osa.h
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+
+/************************************************************************************************
+ *                                                                                              *
+ *                              C A L L B A C K   T I M E R S                                   *
+ *                                                                                              *
+ ************************************************************************************************/
+
+/*
+ *  Configuration (OSAcfg.h):
+ *
+ *      OS_ENABLE_CTIMERS       - enable callback timers
+ *      OS_CTIMER_SIZE          - size of timer counter: 1, 2 or 4 (default OS_TIMER_SIZE)
+ *      OS_CTIMER_PRIORITY      - priority of timer service task (default 0 - highest)
+ *
+ *  Running timers are kept in one list sorted by expiry time; every item holds
+ *  difference from previous one (as qtimers). OS_Timer decrements only first
+ *  item. Service task sleeps till first item reaches zero and then calls
+ *  functions of all timers expired in this tick in one pass.
+ *
+ *      OST_CTIMER  led_timer;
+ *
+ *      void led_toggle (void *arg) { GPIOE->ODR ^= (uint8_t)(uint16_t)arg; }
+ *
+ *      OS_Init();
+ *      OS_Ctimer_Service_Create();
+ *      OS_Ctimer_Create(led_timer, led_toggle, 0x20);
+ *      OS_Ctimer_Start(led_timer, 500, 500);   // first after 500 ticks, then every 500
+ *
+ *  Function is called from service task: it must not call services that
+ *  switch context. It may start and stop timers (including own one).
+ *  Auto-reload timer is restarted before function is called, period is
+ *  counted from expiry time, not from moment of call.
+ *
+ */
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_CTIMERS
+//------------------------------------------------------------------------------
+
+//******************************************************************************
+//  CONFIGURATION
+//******************************************************************************
+
+#ifndef OS_CTIMER_PRIORITY
+    #define OS_CTIMER_PRIORITY  0
+#endif
+
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+extern OST_CTIMER * volatile OS_BANK  _OS_Ctimer_List;     // First (nearest) timer
+extern volatile OS_BANK OS_CTIMER_TYPE _OS_Ctimer_Late;    // Ticks passed after first timer expired
+
+
+//******************************************************************************
+//  FUNCTION PROTOTYPES
+//******************************************************************************
+
+extern void _OS_Ctimer_Insert (OST_CTIMER *pTimer, OS_CTIMER_TYPE Delay);
+extern void _OS_Ctimer_Start (OST_CTIMER *pTimer, OS_CTIMER_TYPE Delay, OS_CTIMER_TYPE Period);
+extern void _OS_Ctimer_Stop  (OST_CTIMER *pTimer);
+extern void _OS_Ctimer_Task  (void);
+
+
+//******************************************************************************
+//  MACROS
+//******************************************************************************
+
+// List is changed by tasks and by OS_Timer
+
+#define __OS_CTIMER_DI()        _OS_DI_INT()
+#define __OS_CTIMER_RI()        _OS_RI_INT()
+
+
+//------------------------------------------------------------------------------
+// Create timer service task
+
+#define OS_Ctimer_Service_Create()  OS_Task_Create(OS_CTIMER_PRIORITY, _OS_Ctimer_Task)
+
+
+//------------------------------------------------------------------------------
+// Create stopped timer with function and its parameter
+
+#define OS_Ctimer_Create(ctimer, func, arg)                                 \
+    OSM_BEGIN {                                                             \
+        (ctimer).pFunc = (func);                                            \
+        (ctimer).pArg  = (void*)(arg);                                      \
+        (ctimer).bActive = 0;                                               \
+    } OSM_END
+
+// Start timer. Period = 0 - one-shot timer, else auto-reload timer.
+// Running timer is restarted.
+
+#define OS_Ctimer_Start(ctimer, delay, period)                              \
+    OSM_BEGIN {                                                             \
+        __OS_CTIMER_DI();                                                   \
+        _OS_Ctimer_Start(&(ctimer), delay, period);                         \
+        __OS_CTIMER_RI();                                                   \
+    } OSM_END
+
+// Stop timer (function will not be called)
+
+#define OS_Ctimer_Stop(ctimer)                                              \
+    OSM_BEGIN {                                                             \
+        __OS_CTIMER_DI();                                                   \
+        _OS_Ctimer_Stop(&(ctimer));                                         \
+        __OS_CTIMER_RI();                                                   \
+    } OSM_END
+
+// Check for timer is running
+#define OS_Ctimer_IsRun(ctimer)     ((ctimer).bActive)
+
+// Change period of auto-reload timer (used at next reload)
+#define OS_Ctimer_SetPeriod(ctimer, period)     (ctimer).Period = (period)
+
+
+
+//------------------------------------------------------------------------------
+#endif      // OS_ENABLE_CTIMERS
+//------------------------------------------------------------------------------
+
+
+//******************************************************************************
+//  END OF FILE osa_ctimer.h
+//******************************************************************************
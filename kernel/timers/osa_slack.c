@@ -0,0 +1,88 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_slack.c
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Functions for timer coalescing
+ *                  This file directly included in osa.c
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_TIMER_SLACK
+//------------------------------------------------------------------------------
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+volatile OS_BANK OST_UINT8  _OS_Slack_Ticks;
+
+
+
+/*
+ ********************************************************************************
+ *
+ *  OST_UINT8 _OS_Timer_Slack (OST_UINT8 time, OST_UINT8 slack)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    (Internal function called by system kernel througth
+ *                  services OS_xxx_Run_S)
+ *
+ *                  Calculate how many ticks to add to timer's time so that
+ *                  timer expires on tick multiple of G (G = largest power of
+ *                  two <= slack). Only low bytes of tick counter and of time
+ *                  are needed for this.
+ *
+ *  parameters:     time    - low byte of timer's time
+ *                  slack   - permitted delay of expiry
+ *
+ *  on return:      0..G-1 - ticks to add
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//------------------------------------------------------------------------------
+#if !defined(_OS_Timer_Slack_DEFINED)
+//------------------------------------------------------------------------------
+
+    OST_UINT8 _OS_Timer_Slack (OST_UINT8 time, OST_UINT8 slack)
+    {
+        // Leave only highest bit of slack
+        while (slack & (slack - 1)) slack &= slack - 1;
+
+        if (slack < 2) return 0;
+
+        time += _OS_Slack_Ticks;
+
+        return (OST_UINT8)(-time) & (slack - 1);
+    }
+
+//------------------------------------------------------------------------------
+#endif  // !defined(_OS_Timer_Slack_DEFINED)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_TIMER_SLACK
+//------------------------------------------------------------------------------
+//******************************************************************************
+//  END OF FILE osa_slack.c
+//******************************************************************************
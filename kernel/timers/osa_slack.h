@@ -0,0 +1,101 @@
+/*
+ ************************************************************************************************
+ *
+ *  OSA cooperative RTOS for microcontrollers PIC, AVR and STM8
+ *
+ *  OSA is distributed under BSD license (see license.txt)
+ *
+ *  URL:            http://wiki.pic24.ru/doku.php/en/osa/ref/intro
+ *
+ *----------------------------------------------------------------------------------------------
+ *
+ *  File:           osa_slack.h
+ *
+ *  Programmer:     STM8 port contributors
+ *                  (layout follows OSA kernel files by Timofeev Victor)
+ *
+ *  Description:    Timer coalescing: starting timers with permitted slack
+ *                  This file directly included in osa.h
+ *
+ *  History:        19.10.2026 -    File created
+ *
+ ************************************************************************************************
+ */
+
+
+
+/************************************************************************************************
+ *                                                                                              *
+ *                               T I M E R   S L A C K                                          *
+ *                                                                                              *
+ ************************************************************************************************/
+
+/*
+ *  Timer started with slack S may expire up to S ticks later than asked.
+ *  Kernel uses this freedom to put expiry on a tick which number (counted by
+ *  OS_Timer) is multiple of G, where G is largest power of two not greater
+ *  than S (max 128). All timers which windows cover the same such tick
+ *  expire together, so there are fewer wakeups:
+ *
+ *      OS_Dtimer_Run_S(led_timer,   500, 20);     // expires in 500..515 ticks
+ *      OS_Stimer_Run_S(RETRY_TIMER, 300, 50);     // expires in 300..331 ticks
+ *
+ *  Timer is never started earlier than asked. Slack 0 or 1 - no alignment.
+ *  Parameter "time" is evaluated twice.
+ *
+ */
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_TIMER_SLACK
+//------------------------------------------------------------------------------
+
+//******************************************************************************
+//  VARIABLES
+//******************************************************************************
+
+extern volatile OS_BANK OST_UINT8   _OS_Slack_Ticks;       // Incremented by OS_Timer
+
+
+//******************************************************************************
+//  FUNCTION PROTOTYPES
+//******************************************************************************
+
+extern OST_UINT8 _OS_Timer_Slack (OST_UINT8 time, OST_UINT8 slack);
+
+
+//******************************************************************************
+//  MACROS
+//******************************************************************************
+
+// Time to start timer with: given time plus alignment (less than slack)
+
+#define OS_Timer_Slack(time, slack)     ((time) + _OS_Timer_Slack((OST_UINT8)(time), slack))
+
+
+#ifdef OS_ENABLE_DTIMERS
+#define OS_Dtimer_Run_S(dtimer, time, slack)        OS_Dtimer_Run(dtimer, OS_Timer_Slack(time, slack))
+#endif
+
+#ifdef OS_ENABLE_QTIMERS
+#define OS_Qtimer_Run_S(ftimer, time, slack)        OS_Qtimer_Run(ftimer, OS_Timer_Slack(time, slack))
+#endif
+
+#if OS_STIMERS > 0
+#define OS_Stimer_Run_S(stimer_id, time, slack)     OS_Stimer_Run(stimer_id, OS_Timer_Slack(time, slack))
+#endif
+
+#ifdef OS_ENABLE_CTIMERS
+#define OS_Ctimer_Start_S(ctimer, delay, period, slack)                     \
+                                    OS_Ctimer_Start(ctimer, OS_Timer_Slack(delay, slack), period)
+#endif
+
+
+
+//------------------------------------------------------------------------------
+#endif      // OS_ENABLE_TIMER_SLACK
+//------------------------------------------------------------------------------
+
+
+//******************************************************************************
+//  END OF FILE osa_slack.h
+//******************************************************************************
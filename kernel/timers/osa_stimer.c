@@ -42,6 +42,12 @@
     OS_STIMERS_BANK     OST_WORD   _OS_StimersFree[(OS_STIMERS + _OST_INT_SIZE-1) / _OST_INT_SIZE];
     #endif
 
+    #ifdef OS_STIMERS_ACTIVE_LIST
+    volatile OS_STIMERS_BANK    OST_UINT8   _OS_Stimer_Act[OS_STIMERS];
+    volatile OS_STIMERS_BANK    OST_UINT8   _OS_Stimer_NAct;
+    OS_STIMERS_BANK             OST_UINT8   _OS_Stimer_Listed[(OS_STIMERS + 7) / 8];
+    #endif
+
 #if (OS_BANK_STIMERS == 0) && defined(__OSA_PIC18_MPLABC__)
 #pragma udata
 #endif
@@ -135,6 +141,51 @@
 
 //-----------------------------------------------------------------
 #endif  //  OS_STIMERS_ENABLE_ALLOCATION
+//-----------------------------------------------------------------
+
+
+
+
+/*
+ ********************************************************************************
+ *
+ *  void _OS_Stimer_Activate (OST_UINT8 ID)
+ *
+ *------------------------------------------------------------------------------
+ *
+ *  description:    (Internal function called by system kernel througth
+ *                  services OS_Stimer_Run and OS_Stimer_Continue)
+ *
+ *                  Add timer to list of running timers processed by OS_Timer
+ *                  (if it is not there yet). Must be called with disabled
+ *                  interrupts.
+ *
+ *  parameters:     ID - timer ID
+ *
+ *  on return:      none
+ *
+ *  Overloaded in:  -
+ *
+ ********************************************************************************
+ */
+
+//-----------------------------------------------------------------
+#if defined(OS_STIMERS_ACTIVE_LIST) && !defined(_OS_Stimer_Activate_DEFINED)
+//-----------------------------------------------------------------
+
+    void _OS_Stimer_Activate (OST_UINT8 ID)
+    {
+        OST_UINT8 mask;
+
+        mask = 1 << (ID & 7);
+        if (_OS_Stimer_Listed[ID >> 3] & mask) return;
+
+        _OS_Stimer_Listed[ID >> 3] |= mask;
+        _OS_Stimer_Act[_OS_Stimer_NAct++] = ID;
+    }
+
+//-----------------------------------------------------------------
+#endif  //  OS_STIMERS_ACTIVE_LIST
 #endif  //  OS_ENABLE_STIMERS
 //-----------------------------------------------------------------
 
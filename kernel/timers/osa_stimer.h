@@ -46,6 +46,12 @@ extern  volatile OS_STIMERS_BANK     OS_STIMER_TYPE     _OS_Stimers[OS_STIMERS]
 extern  OS_STIMERS_BANK     OST_UINT   _OS_StimersFree[(OS_STIMERS + _OST_INT_SIZE-1) / _OST_INT_SIZE];
 #endif
 
+#ifdef OS_STIMERS_ACTIVE_LIST
+extern  volatile OS_STIMERS_BANK    OST_UINT8   _OS_Stimer_Act[OS_STIMERS];     // IDs of running timers
+extern  volatile OS_STIMERS_BANK    OST_UINT8   _OS_Stimer_NAct;                // Number of them
+extern  OS_STIMERS_BANK             OST_UINT8   _OS_Stimer_Listed[(OS_STIMERS + 7) / 8];
+#endif
+
 
 //******************************************************************************
 //  FUNCTION PROTOTYPES
@@ -58,6 +64,12 @@ extern  OS_STIMERS_BANK     OST_UINT   _OS_StimersFree[(OS_STIMERS + _OST_INT_SI
 
 #endif
 
+#ifdef OS_STIMERS_ACTIVE_LIST
+
+    void        _OS_Stimer_Activate (OST_UINT8 ID);
+
+#endif
+
 //******************************************************************************
 //  MACROS
 //******************************************************************************
@@ -82,6 +94,22 @@ extern  OS_STIMERS_BANK     OST_UINT   _OS_StimersFree[(OS_STIMERS + _OST_INT_SI
     } OSM_END
 
 //------------------------------------------------------------------------------
+// With OS_STIMERS_ACTIVE_LIST OS_Timer processes only timers from list of
+// running ones. Timer is put into list when it is run or continued, and is
+// removed from it by OS_Timer when it has expired or been stopped.
+
+#ifdef OS_STIMERS_ACTIVE_LIST
+    #define __OS_Stimer_Activate(stimer_id)                             \
+        OSM_BEGIN {                                                     \
+            char _os_cc = OS_DI();                                      \
+            _OS_Stimer_Activate(stimer_id);                             \
+            OS_RI(_os_cc);                                              \
+        } OSM_END
+#else
+    #define __OS_Stimer_Activate(stimer_id)
+#endif
+
+//------------------------------------------------------------------------------
 
 
 
@@ -129,6 +157,7 @@ extern  OS_STIMERS_BANK     OST_UINT   _OS_StimersFree[(OS_STIMERS + _OST_INT_SI
     {                                                                   \
         OS_Stimer_Stop(stimer_id);                                      \
         _OS_Stimers[stimer_id] = -(OS_STIMER_TYPE)(time);               \
+        __OS_Stimer_Activate(stimer_id);                                \
     }
 
     // At the end of this macro we can't set bit Run since before we do it,
@@ -142,7 +171,11 @@ extern  OS_STIMERS_BANK     OST_UINT   _OS_StimersFree[(OS_STIMERS + _OST_INT_SI
 /************************************************************************/
 
 #define OS_Stimer_Pause(stimer_id)      OS_STIMER_ATOMIC_WRITE_A(_OS_Stimers[stimer_id] &= ~OS_STIMER_RUN_BIT)
-#define OS_Stimer_Continue(stimer_id)   OS_STIMER_ATOMIC_WRITE_A(_OS_Stimers[stimer_id] |= OS_STIMER_RUN_BIT)
+#define OS_Stimer_Continue(stimer_id)                                   \
+    {                                                                   \
+        OS_STIMER_ATOMIC_WRITE_A(_OS_Stimers[stimer_id] |= OS_STIMER_RUN_BIT); \
+        __OS_Stimer_Activate(stimer_id);                                \
+    }
 
 
 /************************************************************************/
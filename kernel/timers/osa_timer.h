@@ -49,7 +49,9 @@
 
 #ifdef OS_ENABLE_OS_TIMER
 
-    #ifndef OS_USE_INLINE_TIMER
+    #if defined(OS_ENABLE_TIMER_DEFER)
+        #define OS_Timer()  __OS_TimerDeferTick()
+    #elif !defined(OS_USE_INLINE_TIMER)
         extern void OS_Timer (void);
     #else
         #define OS_Timer()  __OS_TimerInline()
@@ -58,6 +60,47 @@
 #endif
 
 
+
+/************************************************************************/
+/* Deferred timer work                                                  */
+/************************************************************************/
+
+/*
+ *  When OS_ENABLE_TIMER_DEFER is defined, OS_Timer() called from ISR only
+ *  counts ticks in _OS_Timer_Pending (and _OS_Time32, so OS_GetTime32 and
+ *  OS_GetTime_us stay exact). All timers are processed by OS_Sched before
+ *  searching for ready task: work of every pending tick is done one by one,
+ *  so timeouts are the same as in ISR mode. Scheduler must be called at
+ *  least once per 255 ticks, otherwise ticks are lost.
+ *
+ */
+
+//------------------------------------------------------------------------------
+#ifdef OS_ENABLE_TIMER_DEFER
+//------------------------------------------------------------------------------
+
+    extern volatile OS_BANK OST_UINT8   _OS_Timer_Pending;
+    extern void _OS_Timer_Defer (void);
+
+    #define __OS_TimerDeferTick()                                           \
+        {                                                                   \
+            _OS_Timer_Pending++;                                            \
+            __OS_Time32Tick();                                              \
+        }
+
+    #define __OS_SCHED_TIMER_WORK()     if (_OS_Timer_Pending) _OS_Timer_Defer()
+
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+
+    #define __OS_SCHED_TIMER_WORK()
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_TIMER_DEFER
+//------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------
 #ifndef _OS_DtimersWork_DEFINED
 //------------------------------------------------------------------------------
@@ -94,6 +137,118 @@
 
 
 
+//------------------------------------------------------------------------------
+#ifndef _OS_CtimersWork_DEFINED
+//------------------------------------------------------------------------------
+
+    //------------------------------------------------------------------------------
+    #ifndef OS_ENABLE_CTIMERS
+    //------------------------------------------------------------------------------
+
+        #define __OS_CtimersWork()
+
+    //------------------------------------------------------------------------------
+    #else
+    //------------------------------------------------------------------------------
+
+        // Only first timer of list is decremented. While it waits for service
+        // task, passed ticks are counted in _OS_Ctimer_Late (saturated: list
+        // can not be late for more than OS_CTIMER_TYPE holds).
+
+        #define __OS_CtimersWork()                                              \
+            {                                                                   \
+                if (_OS_Ctimer_List)                                            \
+                {                                                               \
+                    if (_OS_Ctimer_List->Delta) _OS_Ctimer_List->Delta--;       \
+                    else if (_OS_Ctimer_Late != (OS_CTIMER_TYPE)~0)             \
+                        _OS_Ctimer_Late++;                                      \
+                }                                                               \
+            }
+
+    //------------------------------------------------------------------------------
+    #endif  // OS_ENABLE_CTIMERS
+    //------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------
+#ifndef OS_ENABLE_TIME32
+//------------------------------------------------------------------------------
+
+    #define __OS_Time32Work()
+    #define __OS_Time32Tick()
+
+//------------------------------------------------------------------------------
+#elif defined(OS_ENABLE_TIMER_DEFER)
+//------------------------------------------------------------------------------
+
+    // Counted in ISR even in deferred mode
+    #define __OS_Time32Work()
+    #define __OS_Time32Tick()           _OS_Time32++
+
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+
+    #define __OS_Time32Work()           _OS_Time32++
+    #define __OS_Time32Tick()
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_TIME32
+//------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------
+#ifndef OS_ENABLE_TIMER_SLACK
+//------------------------------------------------------------------------------
+
+    #define __OS_SlackWork()
+
+//------------------------------------------------------------------------------
+#else
+//------------------------------------------------------------------------------
+
+    #define __OS_SlackWork()            _OS_Slack_Ticks++
+
+//------------------------------------------------------------------------------
+#endif  // OS_ENABLE_TIMER_SLACK
+//------------------------------------------------------------------------------
+
+
+
+//------------------------------------------------------------------------------
+#ifndef _OS_MtasksWork_DEFINED
+//------------------------------------------------------------------------------
+
+    //------------------------------------------------------------------------------
+    #ifndef OS_ENABLE_MTASKS
+    //------------------------------------------------------------------------------
+
+        #define __OS_MtasksWork()
+
+    //------------------------------------------------------------------------------
+    #else
+    //------------------------------------------------------------------------------
+
+        // Micro-task timers are decremented by host task, here only ticks are counted
+
+        #define __OS_MtasksWork()           _OS_Mtask_Ticks++
+
+    //------------------------------------------------------------------------------
+    #endif  // OS_ENABLE_MTASKS
+    //------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
+
+
+
 //------------------------------------------------------------------------------
 #ifndef _OS_QtimersWork_DEFINED
 //------------------------------------------------------------------------------
@@ -2075,12 +2230,38 @@
 
     #endif
 
+
+    // Only timers from list of running ones are processed. List is walked
+    // from end, so expired (or stopped) timer is replaced by last one,
+    // which is already processed.
+
+    #ifndef __OS_StimersWorkList
+
+        #define __OS_StimersWorkList()                                          \
+        {                                                                       \
+            OST_UINT8 _os_i, _os_id;                                            \
+            _os_i = _OS_Stimer_NAct;                                            \
+            while (_os_i)                                                       \
+            {                                                                   \
+                _os_id = _OS_Stimer_Act[--_os_i];                               \
+                if ((_OS_Stimers[_os_id] & OS_STIMER_RUN_BIT) &&                \
+                    (++_OS_Stimers[_os_id] & OS_STIMER_RUN_BIT)) continue;      \
+                _OS_Stimer_Listed[_os_id >> 3] &= ~(1 << (_os_id & 7));         \
+                _OS_Stimer_Act[_os_i] = _OS_Stimer_Act[--_OS_Stimer_NAct];      \
+            }                                                                   \
+        }
+
+    #endif
+
 #else
 
     #define __OS_StimersWorkSpeed()
     #ifndef __OS_StimersWorkSize
         #define __OS_StimersWorkSize()
     #endif
+    #ifndef __OS_StimersWorkList
+        #define __OS_StimersWorkList()
+    #endif
 
 //------------------------------------------------------------------------------
 #endif  // OS_ENABLE_STIMERS
@@ -2107,6 +2288,89 @@
 
 
 
+/************************************************************************/
+/* Old style static timers: skip of empty OS_Timeouts words             */
+/************************************************************************/
+
+/*
+ *  With OS_TIMERS_SKIP_EMPTY OS_Timer walks OS_Timeouts word by word instead
+ *  of testing every timer: zero word (no running timers) is skipped by one
+ *  test, in non-zero word only bits up to highest set one are tested. Time
+ *  of tick does not depend on number of configured timers but on number of
+ *  running ones.
+ *
+ */
+
+#if OS_TIMERS8 > 0
+    #define __OS_OldTimerTick8(n, w, m)                                             \
+        if ((n) < _OS_TIMER16_POS) {                                                \
+            if (!++OS_Timers8[n]) OS_Timeouts[w] &= ~(m);                           \
+        } else
+#else
+    #define __OS_OldTimerTick8(n, w, m)
+#endif
+
+#if OS_TIMERS16 > 0
+    #define __OS_OldTimerTick16(n, w, m)                                            \
+        if ((n) < _OS_TIMER24_POS) {                                                \
+            if (!++OS_Timers16[(n) - _OS_TIMER16_POS]) OS_Timeouts[w] &= ~(m);      \
+        } else
+#else
+    #define __OS_OldTimerTick16(n, w, m)
+#endif
+
+#if OS_TIMERS24 > 0
+    #define __OS_OldTimerTick24(n, w, m)                                            \
+        if ((n) < _OS_TIMER32_POS) {                                                \
+            if (!(OS_Ticks & 0xFF) && !++OS_Timers24[(n) - _OS_TIMER24_POS])        \
+                OS_Timeouts[w] &= ~(m);                                             \
+        } else
+#else
+    #define __OS_OldTimerTick24(n, w, m)
+#endif
+
+#if OS_TIMERS32 > 0
+    #define __OS_OldTimerTick32(n, w, m)                                            \
+        {                                                                           \
+            if (!++OS_Timers32[(n) - _OS_TIMER32_POS]) OS_Timeouts[w] &= ~(m);      \
+        }
+#else
+    #define __OS_OldTimerTick32(n, w, m)    {}
+#endif
+
+
+#define __OS_OldTimersWorkSkip()                                                    \
+{                                                                                   \
+    OST_UINT  _os_w, _os_t, _os_m;                                                  \
+    OST_UINT8 _os_n;                                                                \
+                                                                                    \
+    _OS_IncOSTicks();                                                               \
+                                                                                    \
+    for (_os_w = 0; _os_w < (OS_TIMERS + _OST_INT_SIZE - 1) / _OST_INT_SIZE; _os_w++) \
+    {                                                                               \
+        _os_t = OS_Timeouts[_os_w];                                                 \
+        if (!_os_t) continue;                                                       \
+        _os_n = _os_w << _OST_INT_SHIFT;                                            \
+        _os_m = 1;                                                                  \
+        while (_os_t)                                                               \
+        {                                                                           \
+            if (_os_t & 1)                                                          \
+            {                                                                       \
+                __OS_OldTimerTick8 (_os_n, _os_w, _os_m)                            \
+                __OS_OldTimerTick16(_os_n, _os_w, _os_m)                            \
+                __OS_OldTimerTick24(_os_n, _os_w, _os_m)                            \
+                __OS_OldTimerTick32(_os_n, _os_w, _os_m)                            \
+            }                                                                       \
+            _os_t >>= 1;                                                            \
+            _os_m <<= 1;                                                            \
+            _os_n++;                                                                \
+        }                                                                           \
+    }                                                                               \
+}
+
+
+
+
 /************************************************************************************************
  *                                                                                              *
  *     S Y S T E M   T I M E R   W O R K   M A C R O                                            *
@@ -2256,7 +2520,11 @@
 
 
 
-#define OS_OldTimer()           __OS_OldTimersWork()
+#if defined(OS_TIMERS_SKIP_EMPTY) && (OS_TIMERS > 0)
+    #define OS_OldTimer()           __OS_OldTimersWorkSkip()
+#else
+    #define OS_OldTimer()           __OS_OldTimersWork()
+#endif
 
 #ifdef OS_TTIMERS_OPTIMIZE_SIZE
     #define OS_Ttimer()             __OS_TtimersWorkSize()
@@ -2264,14 +2532,21 @@
     #define OS_Ttimer()             __OS_TtimersWorkSpeed()
 #endif
 
-#ifdef OS_STIMERS_OPTIMIZE_SIZE
+#if defined(OS_STIMERS_ACTIVE_LIST)
+    #define OS_Stimer()             __OS_StimersWorkList()
+#elif defined(OS_STIMERS_OPTIMIZE_SIZE)
     #define OS_Stimer()             __OS_StimersWorkSize()
 #else
     #define OS_Stimer()             __OS_StimersWorkSpeed()
 #endif
 
 
-#define OS_Dtimer()                 __OS_DtimersWork()
+#if defined(OS_ENABLE_TIMER_DEFER) && defined(OS_ENABLE_DTIMERS)
+    // Dtimers can be changed by _I services from interrupts
+    #define OS_Dtimer()             { char _os_cc = OS_DI(); __OS_DtimersWork(); OS_RI(_os_cc); }
+#else
+    #define OS_Dtimer()             __OS_DtimersWork()
+#endif
 #define OS_Qtimer()                 __OS_QtimersWork()
 
 
@@ -2283,6 +2558,10 @@
     OS_Stimer();                    \
     OS_Dtimer();                    \
     OS_Qtimer();                    \
+    __OS_MtasksWork();              \
+    __OS_Time32Work();              \
+    __OS_CtimersWork();             \
+    __OS_SlackWork();               \
 }
 
 
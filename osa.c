@@ -74,6 +74,14 @@
     OST_TASK_POINTER OS_RAM_NEAR volatile  _OS_CurTask;    // Pointer to current task
     #endif
                                                                     // descriptor.
+
+    #ifdef OS_ENABLE_TIME32
+    volatile OS_BANK        OST_UINT32          _OS_Time32;     // System ticks counter
+    #endif
+
+    #ifdef OS_ENABLE_TIMER_DEFER
+    volatile OS_BANK        OST_UINT8           _OS_Timer_Pending;  // Ticks not processed yet
+    #endif
 //------------------------------------------------------------------------------
 #ifdef __OSA_PIC18_MPLABC__
 #pragma udata
@@ -164,6 +172,12 @@
 #ifdef OS_ENABLE_TTIMERS
 #include "kernel\timers\osa_ttimer.c"
 #endif
+#ifdef OS_ENABLE_CTIMERS
+#include "kernel\timers\osa_ctimer.c"
+#endif
+#ifdef OS_ENABLE_TIMER_SLACK
+#include "kernel\timers\osa_slack.c"
+#endif
 #if defined(OS_ENABLE_SQUEUE) && !defined(OS_QUEUE_SQUEUE_IDENTICAL)
 #include "kernel\events\osa_squeue.c"
 #endif
@@ -172,6 +186,14 @@
 #include "kernel\events\osa_queue.c"
 #endif
 
+#ifdef OS_ENABLE_XQUEUE
+#include "kernel\events\osa_xqueue.c"
+#endif
+
+#ifdef OS_ENABLE_MBUF
+#include "kernel\events\osa_mbuf.c"
+#endif
+
 #ifdef OS_ENABLE_CSEM
 #include "kernel\events\osa_csem.c"
 #endif
@@ -183,6 +205,14 @@
 #include "kernel\system\osa_system.c"
 #include "kernel\system\osa_tasks.c"
 
+#ifdef OS_ENABLE_WORK
+#include "kernel\system\osa_work.c"
+#endif
+
+#ifdef OS_ENABLE_MTASKS
+#include "kernel\system\osa_mtask.c"
+#endif
+
 
 
 
@@ -417,6 +417,10 @@
 #error "OSA error #22: Qtimers are not supported under 12-bit controllers (PIC10 and PIC12)"
 #endif
 
+#if defined(OS_ENABLE_MBUF) && !defined(OS_ENABLE_QUEUE)
+#error "OSA error #27: Message buffers (OS_ENABLE_MBUF) need queues of messages (OS_ENABLE_QUEUE)"
+#endif
+
 
 /*------------------------------------------*/
 /*                                          */
@@ -488,6 +492,9 @@
 
 #define OS_ENABLE_INT_FLAG      /* Enables interrupt services for flags     */
 
+#define OS_ENABLE_INT_WORK      /* Enables interrupt services for work      */
+/* queue                                    */
+
 #endif
 
 
@@ -497,6 +504,8 @@ defined(OS_ENABLE_INT_MSG)   ||                     \
 defined(OS_ENABLE_INT_SMSG)  ||                     \
 defined(OS_ENABLE_INT_QUEUE) ||                     \
 defined(OS_ENABLE_INT_FLAG)  ||                     \
+defined(OS_ENABLE_INT_WORK)  ||                     \
+defined(OS_ENABLE_CTIMERS)   ||                     \
 defined(OS_PROTECT_MEMORY_ACCESS)
 
 
@@ -575,6 +584,10 @@ defined(OS_PROTECT_MEMORY_ACCESS)
 defined(OS_ENABLE_TTIMERS)  ||              \
 defined(OS_ENABLE_STIMERS)  ||              \
 defined(OS_ENABLE_QTIMERS)  ||              \
+defined(OS_ENABLE_MTASKS)   ||              \
+defined(OS_ENABLE_TIME32)   ||              \
+defined(OS_ENABLE_CTIMERS)  ||              \
+defined(OS_ENABLE_TIMER_SLACK) ||           \
 (OS_TIMERS > 0)
 
 #define OS_ENABLE_OS_TIMER
@@ -1035,6 +1048,49 @@ defined(OS_BSEM_BANK)
 #endif
 
 
+//******************************************************************************
+//  Size of micro-task timer's counter
+//******************************************************************************
+
+#if !defined(OS_MTIMER_SIZE)
+#define OS_MTIMER_SIZE  2
+#endif
+
+#if     OS_MTIMER_SIZE == 1
+#define OS_MTIMER_TYPE      OST_UINT8
+
+#elif   OS_MTIMER_SIZE == 2
+#define OS_MTIMER_TYPE      OST_UINT16
+
+#else
+#error "OSA error #28: Bad MTIMER size (must be 1 or 2)"
+/* See manual section "Appendix/Error codes" for more information*/
+#endif
+
+
+//******************************************************************************
+//  Size of callback timer's counter
+//******************************************************************************
+
+#if !defined(OS_CTIMER_SIZE)
+#define OS_CTIMER_SIZE  OS_TIMER_SIZE
+#endif
+
+#if     OS_CTIMER_SIZE == 1
+#define OS_CTIMER_TYPE      OST_UINT8
+
+#elif   OS_CTIMER_SIZE == 2
+#define OS_CTIMER_TYPE      OST_UINT16
+
+#elif   OS_CTIMER_SIZE == 4
+#define OS_CTIMER_TYPE      OST_UINT32
+
+#else
+#error "OSA error #29: Bad CTIMER size (must be 1, 2 or 4)"
+/* See manual section "Appendix/Error codes" for more information*/
+#endif
+
+
 
 
 
@@ -1165,6 +1221,65 @@ typedef struct
 } OST_SQUEUE;
 
 
+/*--- Descriptor of queue of messages copied by value ---*/
+
+typedef struct
+{
+	OST_QUEUE_CONTROL Q;
+	OST_UINT8 *pData;           // Pointer to queue buffer
+	OST_UINT   cElemSize;       // Size of one element in bytes
+
+} OST_XQUEUE;
+
+
+
+/*--- Reference counted message buffers             ---*/
+
+typedef struct
+{
+	void      *pLink;           // Free block: next free block; allocated: pool
+	OST_UINT8  cRefs;           // Number of references to buffer
+
+} OST_MBUF_HDR;
+
+typedef struct
+{
+	OST_MBUF_HDR *pFree;        // List of free blocks
+	OST_UINT      cFree;        // Number of free blocks
+
+} OST_MBUF_POOL;
+
+
+
+//******************************************************************************
+//  Deferred work queue
+//******************************************************************************
+
+typedef void (*OST_WORK_FUNC)(void *);
+
+typedef struct
+{
+	OST_WORK_FUNC  pFunc;       // Function to be called by worker task
+	void          *pArg;        // Its parameter
+
+} OST_WORK;
+
+
+
+//******************************************************************************
+//  Micro-tasks
+//******************************************************************************
+
+typedef struct
+{
+	OST_UINT16        Lc;       // Continuation (line of last wait point)
+	OS_MTIMER_TYPE    Timer;    // Delay/timeout counter
+
+} OST_MTASK;
+
+typedef OST_UINT8 (*OST_MTASK_FUNC)(OST_MTASK *);
+
+
 
 //******************************************************************************
 //  Flags
@@ -1465,6 +1580,25 @@ typedef struct
 
 
 
+//******************************************************************************
+//  Callback timers
+//******************************************************************************
+
+typedef void (*OST_CTIMER_FUNC)(void *);
+
+typedef struct S_OST_CTIMER
+{
+	struct S_OST_CTIMER    *pNext;         // Next timer in list
+	OS_CTIMER_TYPE          Delta;         // Ticks after previous timer in list
+	OS_CTIMER_TYPE          Period;        // 0 - one-shot, else reload value
+	OST_CTIMER_FUNC         pFunc;         // Function called on expiry
+	void                   *pArg;          // Its parameter
+	OST_UINT8               bActive;       // Timer is in list
+	//
+} OST_CTIMER;
+
+
+
 //******************************************************************************
 //  Counting semaphores
 //******************************************************************************
@@ -1635,6 +1769,12 @@ extern  OS_BANK OST_UINT8   _OS_TaskLevel[OS_TASKS];    // Current priority leve
 
 #include "kernel\system\osa_system.h"       // System services
 #include "kernel\system\osa_tasks.h"        // Tasks
+#ifdef OS_ENABLE_WORK
+#include "kernel\system\osa_work.h"         // Deferred work queue
+#endif
+#ifdef OS_ENABLE_MTASKS
+#include "kernel\system\osa_mtask.h"        // Micro-tasks
+#endif
 
 #if OS_BSEMS > 0
 #include "kernel\events\osa_bsem.h"         // Binary semaphores
@@ -1653,6 +1793,12 @@ extern  OS_BANK OST_UINT8   _OS_TaskLevel[OS_TASKS];    // Current priority leve
 #if defined(OS_ENABLE_SQUEUE) && !defined(OS_QUEUE_SQUEUE_IDENTICAL)
 #include "kernel\events\osa_squeue.h"       // Queue of simple messages
 #endif
+#ifdef OS_ENABLE_XQUEUE
+#include "kernel\events\osa_xqueue.h"       // Queue of messages copied by value
+#endif
+#ifdef OS_ENABLE_MBUF
+#include "kernel\events\osa_mbuf.h"         // Reference counted message buffers
+#endif
 #if     OS_STIMERS > 0
 #include "kernel\timers\osa_stimer.h"       // Static timers
 #endif
@@ -1668,6 +1814,12 @@ extern  OS_BANK OST_UINT8   _OS_TaskLevel[OS_TASKS];    // Current priority leve
 #ifdef OS_ENABLE_TTIMERS
 #include "kernel\timers\osa_ttimer.h"       // Task timers
 #endif
+#ifdef OS_ENABLE_CTIMERS
+#include "kernel\timers\osa_ctimer.h"       // Callback timers
+#endif
+#ifdef OS_ENABLE_TIMER_SLACK
+#include "kernel\timers\osa_slack.h"        // Timer coalescing
+#endif
 
 #include "kernel\timers\osa_timer.h"        // System timer
 
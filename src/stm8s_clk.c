@@ -799,6 +799,59 @@ void CLK_ClearITPendingBit(CLK_IT_TypeDef CLK_IT)
 }
 #endif
 
+#ifdef CLK_ChangeClock_Def
+static CLK_Hook_TypeDef CLK_Hooks[CLK_HOOKS];
+static uint8_t CLK_HooksNum;
+
+/**
+  * @brief  Registers function called by CLK_ChangeClock.
+  * @param  Hook : function, gets new fMASTER in Hz. It is called with
+  *         disabled interrupts.
+  * @retval ERROR if table (CLK_HOOKS entries) is full, SUCCESS otherwise.
+  */
+ErrorStatus CLK_AddClockHook(CLK_Hook_TypeDef Hook)
+{
+  if (CLK_HooksNum >= CLK_HOOKS)
+  {
+    return ERROR;
+  }
+  CLK_Hooks[CLK_HooksNum++] = Hook;
+  return SUCCESS;
+}
+
+/**
+  * @brief  Changes HSI or CPU clock divider and reconfigures peripherals
+  *         by registered hooks. Divider change and hooks are done with
+  *         disabled interrupts.
+  * @param  CLK_Prescaler Specifies the HSI or CPU clock divider to apply.
+  * @retval New fMASTER, Hz
+  */
+uint32_t CLK_ChangeClock(CLK_Prescaler_TypeDef CLK_Prescaler)
+{
+  uint32_t fnew;
+  uint8_t i;
+#ifdef __OSA__
+  char cc;
+
+  cc = OS_DI();
+#else
+  disableInterrupts();
+#endif
+  CLK_SYSCLKConfig(CLK_Prescaler);
+  fnew = CLK_GetClockFreq();
+  for (i = 0; i < CLK_HooksNum; i++)
+  {
+    CLK_Hooks[i](fnew);
+  }
+#ifdef __OSA__
+  OS_RI(cc);
+#else
+  enableInterrupts();
+#endif
+  return fnew;
+}
+#endif
+
 /**
   * @}
   */
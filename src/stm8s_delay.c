@@ -40,6 +40,13 @@ void Init_Delay(void)
 	}
 }
 //--------------
+// Hook for CLK_ChangeClock: delays follow new CPU clock
+void Delay_ClockHook(uint32_t fmaster)
+{
+	(void)fmaster;
+	Init_Delay();
+}
+//--------------
 void delay_us( uint16_t ticks )
 {
 	uint16_t t1000=0x3FF,k2;
@@ -63,6 +70,12 @@ if (k2>30)
 */
 }
 //---------------------------
+// Exact loop for delay_us_c: loops*DELAY_LOOP_CYCLES cycles, loops>0
+void delay_loops(uint16_t loops)
+{
+	_asm("$N:\n decw X\n nop \n jrne $L\n ", loops);
+}
+//---------------------------
 void delay_ms(uint16_t ticks )
 {
 	while(ticks--)
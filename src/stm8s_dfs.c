@@ -0,0 +1,109 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_DFS_C
+#define __STM8S_DFS_C
+#include "inc/stm8s_dfs.h"
+
+/* thresholds of busy time in window, 1/256 tick */
+#define DFS_UP_TIME     ((uint16_t)((uint32_t)DFS_WINDOW * 256 * DFS_UP_PCT / 100))
+#define DFS_DOWN_TIME   ((uint16_t)((uint32_t)DFS_WINDOW * 256 * DFS_DOWN_PCT / 100))
+
+static CONST CLK_Prescaler_TypeDef DFS_Presc[3] =
+{
+	CLK_PRESCALER_HSIDIV8, CLK_PRESCALER_HSIDIV2, CLK_PRESCALER_HSIDIV1
+};
+
+volatile uint8_t DFS_Ticks;
+uint8_t DFS_Req;
+volatile uint8_t DFS_Level;
+static uint8_t  DFS_Want;		/* level chosen by load */
+static uint8_t  DFS_LowCnt;		/* windows of low load in row */
+static uint16_t DFS_Last;		/* end of previous scheduler pass */
+static uint16_t DFS_WinStart;	/* start of window */
+static uint16_t DFS_BusyTime;	/* busy time in window */
+
+/* Time in 1/256 tick, wraps every 256 ticks */
+static uint16_t DFS_Now(void)
+{
+	uint8_t t, cnt, per;
+	char cc;
+	cc=OS_DI();
+	t=DFS_Ticks;
+	cnt=TIM4->CNTR;
+	if(TIM4->SR1 & TIM4_SR1_UIF)
+	{
+		/* overflow is not served yet */
+		cnt=TIM4->CNTR;
+		t++;
+	}
+	per=TIM4->ARR;
+	OS_RI(cc);
+	if(cnt>per) cnt=per;	/* preloaded ARR of fractional tick */
+	return ((uint16_t)t<<8) | (uint8_t)(((uint16_t)cnt<<8)/((uint16_t)per+1));
+}
+
+/* Start new window */
+static void DFS_Window(void)
+{
+	DFS_Last=DFS_Now();
+	DFS_WinStart=DFS_Last;
+	DFS_BusyTime=0;
+}
+
+void DFS_Init(void)
+{
+	DFS_Req=0;
+	DFS_LowCnt=0;
+	DFS_Want=DFS_LEVEL_FULL;
+	DFS_Level=DFS_LEVEL_FULL;
+	CLK_AddClockHook(TIM4_OSA_ClockHook);
+	CLK_ChangeClock(DFS_Presc[DFS_LEVEL_FULL]);
+	DFS_Window();
+}
+
+void DFS_Tick(void)
+{
+	DFS_Ticks++;
+}
+
+void DFS_Sched(void)
+{
+	uint16_t now;
+	now=DFS_Now();
+	if(!OS_IsIdle()) DFS_BusyTime+=now-DFS_Last;
+	DFS_Last=now;
+	if((uint16_t)(now-DFS_WinStart)>=((uint16_t)DFS_WINDOW<<8))
+	{
+		if(DFS_BusyTime>DFS_UP_TIME)
+		{
+			DFS_LowCnt=0;
+			if(DFS_Want<DFS_LEVEL_FULL) DFS_Want++;
+		}
+		else if(DFS_BusyTime<DFS_DOWN_TIME)
+		{
+			if(++DFS_LowCnt>=DFS_HOLD)
+			{
+				DFS_LowCnt=0;
+				if(DFS_Want>DFS_LEVEL_LOW) DFS_Want--;
+			}
+		}
+		else
+		{
+			DFS_LowCnt=0;
+		}
+		DFS_WinStart=now;
+		DFS_BusyTime=0;
+	}
+	/* request sets full speed, after release governor goes down by itself */
+	if(DFS_Req)
+	{
+		DFS_Want=DFS_LEVEL_FULL;
+		DFS_LowCnt=0;
+	}
+	if(DFS_Want!=DFS_Level)
+	{
+		CLK_ChangeClock(DFS_Presc[DFS_Want]);
+		DFS_Level=DFS_Want;
+		DFS_Window();	/* load at old clock is not valid any more */
+	}
+}
+#endif
@@ -0,0 +1,206 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_HRTIMER_C
+#define __STM8S_HRTIMER_C
+#include "inc/stm8s_hrtimer.h"
+
+/* Checked here: all headers of drivers are included before this file */
+#if !defined(HRTIMER_USE_TIM1) && defined(MB_USE_TIM2)
+#error "Modbus uses TIM2 (MB_USE_TIM2): define HRTIMER_USE_TIM1 or use TIM3 for Modbus"
+#endif
+#if defined(HRTIMER_USE_TIM1) && defined(OS_TIMER_BENCHMARK)
+#error "OS_TIMER_BENCHMARK uses TIM1: high resolution timers must be on TIM2"
+#endif
+
+static OST_HRTIMER *HRT_List;	/* running timers, nearest first */
+uint8_t HRT_Mul=1;
+uint8_t HRT_Shift;
+static uint8_t HRT_Psc;
+
+/* Prescaler for fMASTER, sets HRT_Mul and HRT_Shift */
+static uint8_t HRT_Calc(uint32_t fmaster)
+{
+	uint8_t mhz, div=0;
+	mhz=(uint8_t)(fmaster/1000000);
+#ifdef HRTIMER_USE_TIM1
+	/* TIM1 has linear prescaler: exact 1 us for any whole MHz */
+	HRT_Mul=1;
+	HRT_Shift=0;
+	return (uint8_t)(mhz-1);
+#else
+	/* count is 1 us or longer: 0x7FFF us fit in half of counter */
+	while((uint8_t)(1<<div)<mhz)
+	{
+		div++;
+	}
+	HRT_Mul=mhz;
+	HRT_Shift=div;
+	while(!(HRT_Mul&1) && HRT_Shift)
+	{
+		HRT_Mul>>=1;
+		HRT_Shift--;
+	}
+	return div;
+#endif
+}
+
+static void HRT_SetPrescaler(uint8_t psc)
+{
+	HRT_Psc=psc;
+#ifdef HRTIMER_USE_TIM1
+	HRTIMER_TIM->PSCRH=0;
+	HRTIMER_TIM->PSCRL=psc;
+#else
+	HRTIMER_TIM->PSCR=psc;
+#endif
+}
+
+uint16_t HRT_UsToCounts(uint16_t us)
+{
+	if(!HRT_Shift) return us;
+	return (uint16_t)(((uint32_t)us*HRT_Mul+(uint8_t)((1<<HRT_Shift)-1))>>HRT_Shift);
+}
+
+void HRT_Init(void)
+{
+	CLK_PeripheralClockConfig(HRTIMER_PERIPHERAL, ENABLE);
+	HRTIMER_TIM->CR1=0;
+	HRT_SetPrescaler(HRT_Calc(CLK_GetClockFreq()));
+	HRTIMER_TIM->ARRH=0xFF;
+	HRTIMER_TIM->ARRL=0xFF;
+	HRTIMER_TIM->CCMR1=0;		/* channel 1: output compare, frozen, no pin */
+	HRTIMER_TIM->IER=0;
+	HRTIMER_TIM->EGR=0x01;		/* UG: load prescaler */
+	HRTIMER_TIM->SR1=0;
+	HRT_List=0;
+	HRTIMER_TIM->CR1=HRTIMER_CEN;
+}
+
+uint16_t HRT_Now(void)
+{
+	uint8_t h;
+	h=HRTIMER_TIM->CNTRH;		/* high byte first: low byte is latched */
+	return ((uint16_t)h<<8)|HRTIMER_TIM->CNTRL;
+}
+
+/* Load compare register with nearest expiry. If it has already passed
+   (timer was started for very short time), compare event is generated by
+   software. Called with disabled interrupts. */
+static void HRT_Program(void)
+{
+	uint16_t exp;
+	if(!HRT_List)
+	{
+		HRTIMER_TIM->IER&=(uint8_t)~HRTIMER_CC1IE;
+		return;
+	}
+	exp=HRT_List->Expire;
+	HRTIMER_TIM->CCR1H=(uint8_t)(exp>>8);
+	HRTIMER_TIM->CCR1L=(uint8_t)exp;
+	HRTIMER_TIM->SR1=(uint8_t)~HRTIMER_CC1IF;
+	HRTIMER_TIM->IER|=HRTIMER_CC1IE;
+	if((int16_t)(exp-HRT_Now())<=0)
+	{
+		HRTIMER_TIM->EGR=HRTIMER_CC1G;
+	}
+}
+
+/* Remove timer from list, returns 1 if it was first. Called with disabled interrupts. */
+static uint8_t HRT_Unlink(OST_HRTIMER *pTimer)
+{
+	OST_HRTIMER **pp;
+	if(!pTimer->bActive) return 0;
+	pTimer->bActive=0;
+	for(pp=&HRT_List;*pp;pp=&(*pp)->pNext)
+	{
+		if(*pp==pTimer)
+		{
+			*pp=pTimer->pNext;
+			return pp==&HRT_List;
+		}
+	}
+	return 0;
+}
+
+/* Put timer to list with expiry exp. Called with disabled interrupts. */
+static void HRT_Insert(OST_HRTIMER *pTimer, uint16_t exp)
+{
+	OST_HRTIMER **pp;
+	HRT_Unlink(pTimer);
+	pTimer->Expire=exp;
+	pTimer->bActive=1;
+	/* place after timers expiring at the same time */
+	for(pp=&HRT_List;*pp && (int16_t)((*pp)->Expire-exp)<=0;pp=&(*pp)->pNext);
+	pTimer->pNext=*pp;
+	*pp=pTimer;
+	if(pp==&HRT_List) HRT_Program();
+}
+
+void HRT_Start(OST_HRTIMER *pTimer, uint16_t us)
+{
+	char cc;
+	cc=OS_DI();
+	HRT_Insert(pTimer, HRT_Now()+HRT_UsToCounts(us));
+	OS_RI(cc);
+}
+
+void HRT_Advance(OST_HRTIMER *pTimer, uint16_t us)
+{
+	char cc;
+	cc=OS_DI();
+	HRT_Insert(pTimer, pTimer->Expire+HRT_UsToCounts(us));
+	OS_RI(cc);
+}
+
+void HRT_Stop(OST_HRTIMER *pTimer)
+{
+	char cc;
+	cc=OS_DI();
+	if(HRT_Unlink(pTimer)) HRT_Program();
+	OS_RI(cc);
+}
+
+void HRT_IRQHandler(void)
+{
+	OST_HRTIMER *t;
+	HRTIMER_TIM->SR1=(uint8_t)~HRTIMER_CC1IF;
+	/* all timers whose time has come, including ones expired during callbacks */
+	while((t=HRT_List)!=0 && (int16_t)(t->Expire-HRT_Now())<=0)
+	{
+		HRT_List=t->pNext;
+		t->bActive=0;
+		if(t->pFunc) t->pFunc(t->pArg);
+	}
+	HRT_Program();
+}
+
+#ifdef CLK_ChangeClock_Def
+void HRT_ClockHook(uint32_t fmaster)
+{
+	OST_HRTIMER *t;
+	uint16_t now;
+	int16_t rest;
+	uint32_t us;
+	uint8_t mul=HRT_Mul, shift=HRT_Shift, psc;
+	psc=HRT_Calc(fmaster);
+	if(psc==HRT_Psc) return;	/* clock is the same (CPUDIV change) */
+	now=HRT_Now();
+	if(HRT_Mul!=mul || HRT_Shift!=shift)
+	{
+		for(t=HRT_List;t;t=t->pNext)
+		{
+			rest=(int16_t)(t->Expire-now);
+			if(rest<0) rest=0;
+			us=((uint32_t)rest<<shift)/mul;
+			if(us>0x7FFF) us=0x7FFF;
+			t->Expire=now+HRT_UsToCounts((uint16_t)us);
+		}
+	}
+	/* UG loads prescaler now but clears counter: counter is written back */
+	HRT_SetPrescaler(psc);
+	HRTIMER_TIM->EGR=0x01;
+	HRTIMER_TIM->CNTRH=(uint8_t)(now>>8);
+	HRTIMER_TIM->CNTRL=(uint8_t)now;
+	HRT_Program();
+}
+#endif
+#endif
@@ -77,6 +77,16 @@ void I2C_DeInit(void)
   I2C->TRISER = I2C_TRISER_RESET_VALUE;
 }
 
+#ifdef CLK_ChangeClock_Def
+/* I2C_Init parameters, used by I2C_ClockHook */
+static uint32_t I2C_OutputHz;
+static uint16_t I2C_OwnAddress;
+static I2C_DutyCycle_TypeDef I2C_Duty;
+static I2C_Ack_TypeDef I2C_Ack;
+static I2C_AddMode_TypeDef I2C_AddMode;
+static uint8_t I2C_InputMHz;
+#endif
+
 /**
   * @brief  Initializes the I2C according to the specified parameters in standard
   *         or fast mode.
@@ -109,6 +119,15 @@ void I2C_Init(uint32_t OutputClockFrequencyHz, uint16_t OwnAddress,
   assert_param(IS_I2C_INPUT_CLOCK_FREQ_OK(InputClockFrequencyMHz));
   assert_param(IS_I2C_OUTPUT_CLOCK_FREQ_OK(OutputClockFrequencyHz));
 
+#ifdef CLK_ChangeClock_Def
+  I2C_OutputHz = OutputClockFrequencyHz;
+  I2C_OwnAddress = OwnAddress;
+  I2C_Duty = I2C_DutyCycle;
+  I2C_Ack = Ack;
+  I2C_AddMode = AddMode;
+  I2C_InputMHz = InputClockFrequencyMHz;
+#endif
+
 	
   /*------------------------- I2C FREQ Configuration ------------------------*/
   /* Clear frequency bits */
@@ -193,6 +212,25 @@ void I2C_Init(uint32_t OutputClockFrequencyHz, uint16_t OwnAddress,
                    (uint8_t)((OwnAddress & (uint16_t)0x0300) >> (uint8_t)7));
 }
 
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Hook for CLK_ChangeClock: repeats I2C_Init with new input clock.
+  *         Bus must be idle.
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void I2C_ClockHook(uint32_t fmaster)
+{
+  uint8_t mhz = (uint8_t)(fmaster / 1000000);
+
+  if ((I2C_OutputHz == 0) || (mhz == I2C_InputMHz))
+  {
+    return;
+  }
+  I2C_Init(I2C_OutputHz, I2C_OwnAddress, I2C_Duty, I2C_Ack, I2C_AddMode, mhz);
+}
+#endif
+
 /**
   * @brief  Enables or disables the I2C peripheral.
   * @param  NewState : Indicate the new I2C peripheral state.
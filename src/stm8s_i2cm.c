@@ -0,0 +1,170 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_I2CM_C
+#define __STM8S_I2CM_C
+#include "inc/stm8s_i2cm.h"
+
+static I2CM_Trans_TypeDef *I2CM_Head;	/* current transaction */
+static I2CM_Trans_TypeDef *I2CM_Tail;
+static uint8_t I2CM_Rd;					/* read part is running */
+static uint8_t I2CM_Idx;				/* bytes of part done */
+
+/* START of transaction or of its read part. STOP of previous one may be
+   still on bus (a few us): START is set after it. */
+static void I2CM_Start(void)
+{
+	uint8_t n=0xFF;
+	while((I2C->CR2&I2C_CR2_STOP) && --n);
+	I2C->ITR=I2C_ITR_ITEVTEN|I2C_ITR_ITBUFEN|I2C_ITR_ITERREN;
+	I2C_GenerateSTART();
+}
+
+static void I2CM_Begin(void)
+{
+	I2CM_Head->Status=I2CM_BUSY;
+	I2CM_Rd=(uint8_t)(!I2CM_Head->WrLen && I2CM_Head->RdLen);
+	I2CM_Idx=0;
+	I2CM_Start();
+}
+
+/* Next transaction is started before done function: it may submit more */
+static void I2CM_Finish(uint8_t status)
+{
+	I2CM_Trans_TypeDef *t=I2CM_Head;
+	I2CM_Head=t->Next;
+	if(I2CM_Head)
+	{
+		I2CM_Begin();
+	}
+	else
+	{
+		I2CM_Tail=0;
+		I2C->ITR=0;
+	}
+	t->Status=status;
+#if defined(__OSA__) && defined(OS_ENABLE_INT_BSEM)
+	if(t->Flags&I2CM_BSEM) OS_Bsem_Set_I(t->Bsem);
+#endif
+	if(t->Done) t->Done(t);
+}
+
+void I2CM_IRQHandler(void)
+{
+	I2CM_Trans_TypeDef *t=I2CM_Head;
+	I2CEventBit_t ev;
+	uint8_t err=I2C->SR2;
+	if(err&(I2C_SR2_AF|I2C_SR2_ARLO|I2C_SR2_BERR|I2C_SR2_OVR))
+	{
+		I2C->SR2=0;
+		if(!t) return;
+		if(!(err&I2C_SR2_ARLO)) I2C_GenerateSTOP();	/* after arbitration loss bus is not ours */
+		I2CM_Finish((err&I2C_SR2_AF) ? I2CM_NACK : I2CM_ERROR);
+		return;
+	}
+	ev.event=I2C_GetLastEvent();	/* SR1 then SR3: clears ADDR */
+	if(!t)
+	{
+		I2C->ITR=0;
+		return;
+	}
+	if(ev.sb)
+	{
+		/* EV5 */
+		if(I2CM_Rd)
+		{
+			I2C_AcknowledgeConfig((t->RdLen==1) ? I2C_ACK_NONE : I2C_ACK_CURR);
+			I2C_Send7bitAddress((uint8_t)(t->Addr<<1), I2C_DIRECTION_RX);
+		}
+		else
+		{
+			I2C_Send7bitAddress((uint8_t)(t->Addr<<1), I2C_DIRECTION_TX);
+		}
+		return;
+	}
+	if(ev.addr)
+	{
+		/* EV6 */
+		if(I2CM_Rd)
+		{
+			if(t->RdLen==1) I2C_GenerateSTOP();
+		}
+		else if(t->WrLen)
+		{
+			I2C_SendData(t->WrBuf[I2CM_Idx++]);
+		}
+		else
+		{
+			/* address probe: slave is there */
+			I2C_GenerateSTOP();
+			I2CM_Finish(I2CM_OK);
+		}
+		return;
+	}
+	if(ev.rxne)
+	{
+		/* EV7 */
+		t->RdBuf[I2CM_Idx++]=I2C_ReceiveData();
+		if(I2CM_Idx==t->RdLen)
+		{
+			I2CM_Finish(I2CM_OK);
+		}
+		else if(I2CM_Idx==(uint8_t)(t->RdLen-1))
+		{
+			I2C_AcknowledgeConfig(I2C_ACK_NONE);
+			I2C_GenerateSTOP();
+		}
+		return;
+	}
+	if(!ev.txe || I2CM_Rd) return;
+	if(I2CM_Idx<t->WrLen)
+	{
+		/* EV8 */
+		I2C_SendData(t->WrBuf[I2CM_Idx++]);
+		return;
+	}
+	if(!ev.btf)
+	{
+		/* last byte is in shift register: wait for BTF */
+		I2C->ITR&=(uint8_t)~I2C_ITR_ITBUFEN;
+		return;
+	}
+	/* EV8_2 */
+	if(!t->RdLen)
+	{
+		I2C_GenerateSTOP();
+		I2CM_Finish(I2CM_OK);
+		return;
+	}
+	I2CM_Rd=1;
+	I2CM_Idx=0;
+	if(!(t->Flags&I2CM_RESTART)) I2C_GenerateSTOP();
+	I2CM_Start();
+}
+
+void I2CM_Submit(I2CM_Trans_TypeDef *t)
+{
+	char cc;
+	t->Next=0;
+	t->Status=I2CM_QUEUED;
+	cc=OS_DI();
+	if(I2CM_Tail)
+	{
+		I2CM_Tail->Next=t;
+		I2CM_Tail=t;
+	}
+	else
+	{
+		I2CM_Head=I2CM_Tail=t;
+		I2CM_Begin();
+	}
+	OS_RI(cc);
+}
+
+void I2CM_Init(uint32_t speed)
+{
+	CLK_PeripheralClockConfig(CLK_PERIPHERAL_I2C, ENABLE);
+	I2C->ITR=0;
+	I2CM_Head=I2CM_Tail=0;
+	I2C_Init(speed, 0, I2C_DUTYCYCLE_2, I2C_ACK_CURR, I2C_ADDMODE_7BIT,
+	         (uint8_t)(CLK_GetClockFreq()/1000000));
+}
+#endif
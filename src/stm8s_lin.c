@@ -0,0 +1,243 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_LIN_C
+#define __STM8S_LIN_C
+#include "inc/stm8s_lin.h"
+
+#if defined(F_CPU) && UART_DIV_BAD(F_CPU, LIN_BAUD)
+#error "LIN_BAUD can not be made from F_CPU"
+#endif
+
+#define LIN_ST_IDLE     0       /* waiting for break */
+#define LIN_ST_SYNC     1       /* waiting for sync byte */
+#define LIN_ST_PID      2       /* waiting for identifier */
+#define LIN_ST_RX       3       /* receiving response */
+#define LIN_ST_TX       4       /* sending response, waiting for echo */
+
+volatile uint8_t LIN_BusErrors;
+static LIN_Frame_TypeDef *LIN_Frames;
+static uint8_t LIN_NFrames;
+static uint8_t LIN_State;
+static LIN_Frame_TypeDef *LIN_Cur;	/* frame of response */
+static uint8_t *LIN_Ptr;			/* its buffer */
+static uint8_t LIN_Idx;				/* bytes of response done */
+static uint8_t LIN_Sum;				/* checksum so far */
+static uint8_t LIN_Echo;			/* byte sent, expected back */
+static const LIN_Slot_TypeDef *LIN_Table;
+static uint8_t LIN_NSlots;
+static uint8_t LIN_Slot;			/* next slot */
+static uint8_t LIN_Left;			/* ticks till next header */
+static uint8_t LIN_Header;			/* PID of header being sent, 0 - none */
+#ifdef LIN_USE_HRTIMER
+static OST_HRTIMER LIN_Timer;
+#endif
+
+uint8_t LIN_Pid(uint8_t id)
+{
+	uint8_t p;
+	id&=0x3F;
+	p=(uint8_t)((id^(id>>1)^(id>>2)^(id>>4))&0x01);		/* P0 = ID0^ID1^ID2^ID4 */
+	p|=(uint8_t)((~((id>>1)^(id>>3)^(id>>4)^(id>>5))&0x01)<<1);	/* P1 = !(ID1^ID3^ID4^ID5) */
+	return (uint8_t)(id|(p<<6));
+}
+
+/* Sum with carry wrap-around */
+static void LIN_Add(uint8_t d)
+{
+	uint8_t s=(uint8_t)(LIN_Sum+d);
+	if(s<d) s++;
+	LIN_Sum=s;
+}
+
+/* Next byte of published response: data, then checksum */
+static void LIN_Send(void)
+{
+	uint8_t d;
+	if(LIN_Idx<LIN_Cur->Len)
+	{
+		d=LIN_Ptr[LIN_Idx++];
+		LIN_Add(d);
+	}
+	else
+	{
+		d=(uint8_t)~LIN_Sum;
+		LIN_Idx++;
+	}
+	LIN_Echo=d;
+	LIN_TX(d);
+}
+
+/* Identifier received: start response if frame is ours */
+static void LIN_Start(uint8_t pid)
+{
+	LIN_Frame_TypeDef *f=LIN_Frames;
+	uint8_t n=LIN_NFrames, id=(uint8_t)(pid&0x3F);
+	LIN_State=LIN_ST_IDLE;
+	if(pid!=LIN_Pid(id))
+	{
+		LIN_BusErrors++;
+		return;
+	}
+	for(;n && f->Id!=id;n--,f++);
+	if(!n) return;
+	LIN_Cur=f;
+	LIN_Idx=0;
+	LIN_Sum=((f->Flags&LIN_CLASSIC) || id>=60) ? 0 : pid;
+	if(f->Flags&LIN_PUBLISH)
+	{
+		if(f->Pending)
+		{
+			f->Front^=1;
+			f->Pending=0;
+		}
+		LIN_Ptr=f->Buf[f->Front];
+		LIN_State=LIN_ST_TX;
+		LIN_Send();
+	}
+	else
+	{
+		LIN_Ptr=f->Buf[f->Front^1];
+		LIN_State=LIN_ST_RX;
+	}
+}
+
+void LIN_RxIRQ(void)
+{
+	uint8_t sr, d;
+	sr=LIN_UART->SR;
+	if(LIN_UART->CR4&LIN_CR4_LBDF)
+	{
+		/* break: any frame is over, header begins */
+		LIN_UART->CR4&=(uint8_t)~LIN_CR4_LBDF;
+		if(sr&UART_SR_RXNE) d=LIN_UART->DR;
+		if(LIN_State>=LIN_ST_RX) LIN_Cur->Errors++;
+		LIN_State=LIN_ST_SYNC;
+		if(LIN_Header) LIN_TX(0x55);
+		return;
+	}
+	if(!(sr&UART_SR_RXNE)) return;
+	d=LIN_UART->DR;		/* SR then DR: clears RXNE and error flags */
+	if(sr&(UART_SR_FE|UART_SR_OR|UART_SR_NF))
+	{
+		/* zero byte of break has FE too: frame is finished by LBDF */
+		if(LIN_State!=LIN_ST_IDLE && LIN_State<LIN_ST_RX) LIN_BusErrors++;
+		if(LIN_State>=LIN_ST_RX) LIN_Cur->Errors++;
+		LIN_State=LIN_ST_IDLE;
+		return;
+	}
+	switch(LIN_State)
+	{
+	case LIN_ST_SYNC:
+		if(d!=0x55)
+		{
+			LIN_BusErrors++;
+			LIN_State=LIN_ST_IDLE;
+			break;
+		}
+		LIN_State=LIN_ST_PID;
+		if(LIN_Header) LIN_TX(LIN_Header);
+		break;
+	case LIN_ST_PID:
+		if(LIN_Header && d!=LIN_Header) LIN_BusErrors++;
+		LIN_Header=0;
+		LIN_Start(d);
+		break;
+	case LIN_ST_RX:
+		if(LIN_Idx<LIN_Cur->Len)
+		{
+			LIN_Ptr[LIN_Idx++]=d;
+			LIN_Add(d);
+			break;
+		}
+		if(d==(uint8_t)~LIN_Sum)
+		{
+			LIN_Cur->Front^=1;
+			LIN_Cur->Updated=1;
+		}
+		else
+		{
+			LIN_Cur->Errors++;
+		}
+		LIN_State=LIN_ST_IDLE;
+		break;
+	case LIN_ST_TX:
+		if(d!=LIN_Echo)
+		{
+			LIN_Cur->Errors++;	/* readback error: bus conflict */
+			LIN_State=LIN_ST_IDLE;
+			break;
+		}
+		if(LIN_Idx>LIN_Cur->Len)
+		{
+			LIN_State=LIN_ST_IDLE;	/* checksum is on bus */
+			break;
+		}
+		LIN_Send();
+		break;
+	}
+}
+
+void LIN_Tick(void)
+{
+	const LIN_Slot_TypeDef *s;
+	if(!LIN_NSlots || --LIN_Left) return;
+	s=&LIN_Table[LIN_Slot];
+	if(++LIN_Slot>=LIN_NSlots) LIN_Slot=0;
+	LIN_Left=s->Time;
+	/* previous frame is not complete: no response or lost header */
+	if(LIN_State>=LIN_ST_RX) LIN_Cur->Errors++;
+	else if(LIN_State!=LIN_ST_IDLE || LIN_Header) LIN_BusErrors++;
+	LIN_State=LIN_ST_IDLE;
+	LIN_Header=LIN_Pid(s->Id);
+	LIN_BREAK();
+}
+
+#ifdef LIN_USE_HRTIMER
+static void LIN_TimerFunc(void *arg)
+{
+	HRT_Advance(&LIN_Timer, LIN_TIMEBASE_US);	/* from previous expiry: no drift */
+	LIN_Tick();
+}
+#endif
+
+void LIN_Schedule(const LIN_Slot_TypeDef *table, uint8_t n)
+{
+	char cc;
+	cc=OS_DI();
+	LIN_Table=table;
+	LIN_NSlots=n;
+	LIN_Slot=0;
+	LIN_Left=1;
+	OS_RI(cc);
+#ifdef LIN_USE_HRTIMER
+	HRT_Stop(&LIN_Timer);	/* before Create clears bActive of running timer */
+	if(n)
+	{
+		OS_Hrtimer_Create(LIN_Timer, LIN_TimerFunc, 0);
+		HRT_Start(&LIN_Timer, LIN_TIMEBASE_US);
+	}
+#endif
+}
+
+void LIN_Init(LIN_Frame_TypeDef *frames, uint8_t n)
+{
+	uint16_t div;
+#ifdef F_CPU
+	div=(uint16_t)UART_DIV(F_CPU, LIN_BAUD);
+#else
+	uint32_t f=CLK_GetClockFreq();
+	div=(uint16_t)UART_DIV(f, LIN_BAUD);
+#endif
+	LIN_Frames=frames;
+	LIN_NFrames=n;
+	LIN_NSlots=0;
+	LIN_Header=0;
+	LIN_State=LIN_ST_IDLE;
+	LIN_BusErrors=0;
+	LIN_UART->CR2=0;
+	LIN_UART->CR1=0;				/* 8 bits, no parity */
+	LIN_UART->CR3=LIN_CR3_LINEN;	/* 1 stop bit, LIN mode */
+	UART_SET_DIV(LIN_UART, div);
+	LIN_UART->CR4=LIN_CR4_LBDIEN|LIN_CR4_LBDL;
+	LIN_UART->CR2=UART_CR2_TEN|UART_CR2_REN|UART_CR2_RIEN;
+}
+#endif
@@ -0,0 +1,282 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_MODBUS_C
+#define __STM8S_MODBUS_C
+#include "inc/stm8s_modbus.h"
+
+#ifdef MB_DE_PORT
+#define MB_DE_ON()      (MB_DE_PORT->ODR |= (uint8_t)(MB_DE_PIN))
+#define MB_DE_OFF()     (MB_DE_PORT->ODR &= (uint8_t)~(MB_DE_PIN))
+#else
+#define MB_DE_ON()
+#define MB_DE_OFF()
+#endif
+
+volatile uint8_t MB_State;
+volatile uint8_t MB_Errors;
+static uint8_t MB_Addr;
+static const MB_Map_TypeDef *MB_Map;
+static uint8_t MB_Buf[MB_BUF_SIZE];
+static uint16_t MB_Len;				/* bytes of frame received */
+static uint16_t MB_Crc;				/* CRC of them */
+static uint8_t MB_Bad;				/* frame is spoilt */
+static const uint8_t *MB_TxPtr;		/* part of response being sent */
+static uint8_t MB_TxLeft;
+static const uint8_t *MB_TxData;	/* register data after header */
+static uint8_t MB_TxDataLen;
+static uint16_t MB_TxCrc;
+static uint8_t MB_TxTail;			/* CRC bytes left */
+
+/* CRC-16 (polynomial 0xA001 reflected), four bits at a time */
+static CONST uint16_t MB_CrcTable[16] =
+{
+	0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+	0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+};
+
+static uint16_t MB_CrcByte(uint16_t crc, uint8_t d)
+{
+	crc=(crc>>4)^MB_CrcTable[(uint8_t)(crc^d)&0x0F];
+	crc=(crc>>4)^MB_CrcTable[(uint8_t)(crc^(d>>4))&0x0F];
+	return crc;
+}
+
+/* Count T1.5/T3.5 from now */
+static void MB_Restart(void)
+{
+	MB_TIM->CNTRH=0;
+	MB_TIM->CNTRL=0;
+	MB_TIM->SR1=(uint8_t)~MB_TIM_CC1IF;
+	MB_TIM->CR1|=MB_TIM_CEN;
+}
+
+void MB_TimerIRQ(void)
+{
+	MB_TIM->SR1=(uint8_t)~MB_TIM_UIF;
+	if(MB_State==MB_IDLE && MB_Len)
+	{
+		if(MB_Bad || MB_Len<4 || MB_Crc)
+		{
+			MB_Errors++;
+		}
+		else if(MB_Buf[0]==MB_Addr || MB_Buf[0]==0)
+		{
+			MB_State=MB_READY;
+		}
+	}
+	if(MB_State!=MB_READY) MB_Len=0;
+	MB_Bad=0;
+	MB_Crc=0xFFFF;
+}
+
+void MB_RxIRQ(void)
+{
+	uint8_t sr, d, gap;
+	sr=MB_UART->SR;
+	d=MB_UART->DR;		/* SR then DR: clears RXNE and error flags */
+	if(MB_TIM->SR1&MB_TIM_UIF) MB_TimerIRQ();	/* previous frame is over, not served yet */
+	gap=(uint8_t)(MB_TIM->SR1&MB_TIM_CC1IF);
+	MB_Restart();
+	if(MB_State!=MB_IDLE) return;
+	if((sr&(UART_SR_OR|UART_SR_NF|UART_SR_FE|UART_SR_PE)) || (gap && MB_Len) || MB_Len>=MB_BUF_SIZE)
+	{
+		MB_Bad=1;
+		return;
+	}
+	MB_Buf[MB_Len++]=d;
+	MB_Crc=MB_CrcByte(MB_Crc, d);
+}
+
+void MB_TxIRQ(void)
+{
+	uint8_t sr, d;
+	sr=MB_UART->SR;
+	if((MB_UART->CR2&UART_CR2_TCIEN) && (sr&UART_SR_TC))
+	{
+		/* last bit is out: back to receive */
+		MB_UART->CR2&=(uint8_t)~UART_CR2_TCIEN;
+		MB_DE_OFF();
+		MB_Len=0;
+		MB_State=MB_IDLE;
+		return;
+	}
+	if(!(MB_UART->CR2&UART_CR2_TIEN) || !(sr&UART_SR_TXE)) return;
+	if(!MB_TxLeft && MB_TxDataLen)
+	{
+		MB_TxPtr=MB_TxData;
+		MB_TxLeft=MB_TxDataLen;
+		MB_TxDataLen=0;
+	}
+	if(MB_TxLeft)
+	{
+		d=*MB_TxPtr++;
+		MB_TxLeft--;
+		MB_TxCrc=MB_CrcByte(MB_TxCrc, d);
+		MB_UART->DR=d;
+		return;
+	}
+	/* CRC, low byte first */
+	MB_UART->DR=(MB_TxTail==2) ? (uint8_t)MB_TxCrc : (uint8_t)(MB_TxCrc>>8);
+	if(!--MB_TxTail)
+	{
+		MB_UART->CR2&=(uint8_t)~UART_CR2_TIEN;
+		MB_UART->CR2|=UART_CR2_TCIEN;
+	}
+}
+
+/* Area holding all of registers addr..addr+num-1, 0 if none */
+static const MB_Area_TypeDef *MB_Find(const MB_Area_TypeDef *a, uint8_t n, uint16_t addr, uint16_t num)
+{
+	for(;n;n--,a++)
+	{
+		if(addr>=a->Addr && (uint32_t)addr+num<=(uint32_t)a->Addr+a->Num) return a;
+	}
+	return 0;
+}
+
+uint8_t MB_Poll(void)
+{
+	uint8_t *b=MB_Buf, ex=0, len=6, i;
+	uint16_t addr, num, *p;
+	const MB_Area_TypeDef *a;
+	if(MB_State!=MB_READY) return 0;
+	addr=((uint16_t)b[2]<<8)|b[3];
+	num=((uint16_t)b[4]<<8)|b[5];	/* number of registers or value */
+	MB_TxDataLen=0;
+	switch(b[1])
+	{
+	case 3:
+	case 4:
+		if(MB_Len!=8 || num<1 || num>125)
+		{
+			ex=3;
+		}
+		else if(!(a=(b[1]==3) ? MB_Find(MB_Map->Hold, MB_Map->NHold, addr, num)
+			: MB_Find(MB_Map->Input, MB_Map->NInput, addr, num)))
+		{
+			ex=2;
+		}
+		else
+		{
+			/* data go from application memory, no copy */
+			b[2]=(uint8_t)(num<<1);
+			MB_TxData=(const uint8_t *)(a->Data+(addr-a->Addr));
+			MB_TxDataLen=b[2];
+			len=3;
+		}
+		break;
+	case 6:
+		if(MB_Len!=8)
+		{
+			ex=3;
+		}
+		else if(!(a=MB_Find(MB_Map->Hold, MB_Map->NHold, addr, 1)))
+		{
+			ex=2;
+		}
+		else
+		{
+			a->Data[addr-a->Addr]=num;
+			if(MB_Map->Written) MB_Map->Written(addr, 1);
+		}
+		break;
+	case 16:
+		if(MB_Len<9 || num<1 || num>123 || b[6]!=(uint8_t)(num<<1) || MB_Len!=9+b[6])
+		{
+			ex=3;
+		}
+		else if(!(a=MB_Find(MB_Map->Hold, MB_Map->NHold, addr, num)))
+		{
+			ex=2;
+		}
+		else
+		{
+			p=a->Data+(addr-a->Addr);
+			for(i=0;i<(uint8_t)num;i++)
+			{
+				p[i]=((uint16_t)b[7+2*i]<<8)|b[8+2*i];
+			}
+			if(MB_Map->Written) MB_Map->Written(addr, num);
+		}
+		break;
+	default:
+		ex=1;
+		break;
+	}
+	if(!b[0])
+	{
+		/* broadcast: no response */
+		MB_Len=0;
+		MB_State=MB_IDLE;
+		return 1;
+	}
+	if(ex)
+	{
+		b[1]|=0x80;
+		b[2]=ex;
+		len=3;
+		MB_TxDataLen=0;
+	}
+	/* header (or echo of write request) from buffer, then data, then CRC */
+	MB_TxPtr=b;
+	MB_TxLeft=len;
+	MB_TxCrc=0xFFFF;
+	MB_TxTail=2;
+	MB_State=MB_SEND;
+	MB_DE_ON();
+	MB_UART->CR2|=UART_CR2_TIEN;
+	return 1;
+}
+
+void MB_Init(uint8_t addr, uint32_t baud, uint8_t format, const MB_Map_TypeDef *map)
+{
+	uint32_t f, ft, t35, t15;
+	uint16_t div;
+	uint8_t psc=0;
+	MB_Addr=addr;
+	MB_Map=map;
+	MB_State=MB_IDLE;
+	MB_Len=0;
+	MB_Crc=0xFFFF;
+	MB_Bad=1;			/* bytes before first T3.5 gap are dropped */
+	MB_Errors=0;
+	f=CLK_GetClockFreq();
+#ifdef MB_DE_PORT
+	MB_DE_OFF();
+	MB_DE_PORT->CR1|=(uint8_t)(MB_DE_PIN);
+	MB_DE_PORT->DDR|=(uint8_t)(MB_DE_PIN);
+#endif
+	div=(uint16_t)UART_DIV(f, baud);
+	MB_UART->CR2=0;
+	MB_UART->CR1=(uint8_t)(format&(UART_CR1_M|UART_CR1_PCEN|UART_CR1_PS));
+	MB_UART->CR3=(format&MB_8N2) ? UART_CR3_STOP2 : 0;
+	UART_SET_DIV(MB_UART, div);
+	/* gaps in timer ticks: 11 bit character, fixed above 19200 baud */
+	do
+	{
+		ft=f>>psc;
+		if(baud>19200)
+		{
+			t35=ft/1000*1750/1000;
+			t15=ft/1000*750/1000;
+		}
+		else
+		{
+			t35=ft*77/(baud<<1);
+			t15=ft*33/(baud<<1);
+		}
+	} while(t35>0xFFFF && ++psc<15);
+	CLK_PeripheralClockConfig(MB_TIM_PERIPHERAL, ENABLE);
+	MB_TIM->CR1=MB_TIM_OPM;		/* stops at T3.5 */
+	MB_TIM->PSCR=psc;
+	MB_TIM->ARRH=(uint8_t)(t35>>8);
+	MB_TIM->ARRL=(uint8_t)t35;
+	MB_TIM->CCR1H=(uint8_t)(t15>>8);
+	MB_TIM->CCR1L=(uint8_t)t15;
+	MB_TIM->CCMR1=0;			/* channel 1: output compare, frozen, no pin */
+	MB_TIM->EGR=0x01;			/* UG: load prescaler */
+	MB_TIM->SR1=0;
+	MB_TIM->IER=MB_TIM_UIF;		/* UIE */
+	MB_UART->CR2=UART_CR2_TEN|UART_CR2_REN|UART_CR2_RIEN;
+	MB_Restart();
+}
+#endif
@@ -56,6 +56,12 @@ void SPI_DeInit(void)
   SPI->CRCPR  = SPI_CRCPR_RESET_VALUE;
 }
 
+#ifdef CLK_ChangeClock_Def
+/* fMASTER and baud rate prescaler set by SPI_Init, used by SPI_ClockHook */
+static uint32_t SPI_Fmaster;
+static uint8_t SPI_BaudRate;
+#endif
+
 /**
   * @brief  Initializes the SPI according to the specified parameters.
   * @param  FirstBit : This parameter can be any of the 
@@ -86,6 +92,11 @@ void SPI_Init(SPI_FirstBit_TypeDef FirstBit, SPI_BaudRatePrescaler_TypeDef BaudR
   assert_param(IS_SPI_DATA_DIRECTION_OK(Data_Direction));
   assert_param(IS_SPI_SLAVEMANAGEMENT_OK(Slave_Management));
   assert_param(IS_SPI_CRC_POLYNOMIAL_OK(CRCPolynomial));
+
+#ifdef CLK_ChangeClock_Def
+  SPI_Fmaster = CLK_GetClockFreq();
+  SPI_BaudRate = (uint8_t)BaudRatePrescaler;
+#endif
   
   /* Frame Format, BaudRate, Clock Polarity and Phase configuration */
   SPI->CR1 = (uint8_t)((uint8_t)((uint8_t)FirstBit | BaudRatePrescaler) |
@@ -110,6 +121,37 @@ void SPI_Init(SPI_FirstBit_TypeDef FirstBit, SPI_BaudRatePrescaler_TypeDef BaudR
   SPI->CRCPR = (uint8_t)CRCPolynomial;
 }
 
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Hook for CLK_ChangeClock: changes baud rate prescaler so that SCK
+  *         is as near as possible to one set by SPI_Init, but not faster
+  *         (if prescaler range allows). Transfer must not be in progress.
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void SPI_ClockHook(uint32_t fmaster)
+{
+  uint8_t br;
+
+  if (SPI_Fmaster == 0)
+  {
+    return;
+  }
+  br = (uint8_t)(SPI_BaudRate >> 3);
+  while ((fmaster > SPI_Fmaster) && (br < 7))
+  {
+    fmaster >>= 1;
+    br++;
+  }
+  while (((fmaster << 1) <= SPI_Fmaster) && (br > 0))
+  {
+    fmaster <<= 1;
+    br--;
+  }
+  SPI->CR1 = (uint8_t)((SPI->CR1 & (uint8_t)(~SPI_CR1_BR)) | (uint8_t)(br << 3));
+}
+#endif
+
 /**
   * @brief  Enables or disables the SPI peripheral.
   * @param  NewState New state of the SPI peripheral.
@@ -0,0 +1,304 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_SUART_C
+#define __STM8S_SUART_C
+#include "inc/stm8s_suart.h"
+
+static SUART_TypeDef *SUART_Chans[SUART_MAX_CHANNELS];
+static uint8_t SUART_N;
+
+#ifdef SUART_BENCHMARK
+volatile uint32_t SUART_BenchCycles;
+volatile uint32_t SUART_BenchBits;
+volatile uint16_t SUART_BenchMax;
+static uint16_t SUART_BenchZero;
+
+static uint16_t SUART_BenchCnt(void)
+{
+	uint8_t h;
+	h=TIM1->CNTRH;		/* high byte first: low byte is latched */
+	return ((uint16_t)h<<8)|TIM1->CNTRL;
+}
+
+static void SUART_BenchInit(void)
+{
+	uint16_t t;
+	CLK_PeripheralClockConfig(CLK_PERIPHERAL_TIMER1, ENABLE);
+	TIM1->PSCRH=0;
+	TIM1->PSCRL=0;
+	TIM1->ARRH=0xFF;
+	TIM1->ARRL=0xFF;
+	TIM1->EGR=TIM1_EGR_UG;
+	TIM1->CR1=TIM1_CR1_CEN;
+	t=SUART_BenchCnt();
+	SUART_BenchZero=SUART_BenchCnt()-t;
+	SUART_BenchCycles=0;
+	SUART_BenchBits=0;
+	SUART_BenchMax=0;
+}
+#endif
+
+/* Ask compare interrupt now: it finds nearest event itself */
+#define SUART_Kick()    (HRTIMER_TIM->EGR=SUART_CC2G)
+
+/* End of stop bit: next byte from ring or line is idle */
+static void SUART_TxBit(SUART_TypeDef *ch)
+{
+	if(!ch->TxCnt)
+	{
+		if(ch->TxOut==ch->TxIn)
+		{
+			ch->TxOn=0;
+			return;
+		}
+		ch->TxShift=((uint16_t)ch->TxBuf[ch->TxOut&ch->TxMask]<<1)|0x200;	/* start 0, data, stop 1 */
+		ch->TxOut++;
+		ch->TxCnt=10;
+	}
+	if(ch->TxShift&1) ch->TxPort->ODR|=ch->TxPin;
+	else ch->TxPort->ODR&=(uint8_t)~ch->TxPin;
+	ch->TxShift>>=1;
+	ch->TxCnt--;
+	ch->TxDue+=ch->Bit;
+}
+
+static void SUART_RxBit(SUART_TypeDef *ch)
+{
+	uint8_t b=(uint8_t)(ch->RxPort->IDR&ch->RxPin), n;
+	ch->RxDue+=ch->Bit;
+	n=--ch->RxCnt;
+	if(n==9)
+	{
+		/* middle of start bit: glitch if line is high again */
+		if(!b) return;
+	}
+	else if(n)
+	{
+		ch->RxShift>>=1;
+		if(b) ch->RxShift|=0x80;
+		return;
+	}
+	else if(b && (uint8_t)(ch->RxIn-ch->RxOut)<=ch->RxMask)
+	{
+		ch->RxBuf[ch->RxIn&ch->RxMask]=ch->RxShift;
+		ch->RxIn++;
+	}
+	else
+	{
+		ch->RxErrors++;
+	}
+	ch->RxCnt=0;
+	ch->RxPort->CR2|=ch->RxPin;		/* wait for next start bit */
+}
+
+void SUART_IRQHandler(void)
+{
+	SUART_TypeDef *ch;
+	uint16_t now, due;
+	int16_t next;
+	uint8_t i;
+#ifdef SUART_BENCHMARK
+	uint16_t t0=SUART_BenchCnt(), bits=0;
+#endif
+	if(!(HRTIMER_TIM->SR1&SUART_CC2IF)) return;
+	do
+	{
+		HRTIMER_TIM->SR1=(uint8_t)~SUART_CC2IF;
+		now=HRT_Now();
+		next=0x7FFF;
+		for(i=0;i<SUART_N;i++)
+		{
+			ch=SUART_Chans[i];
+			if(ch->RxCnt)
+			{
+				if((int16_t)(ch->RxDue-now)<=SUART_EARLY)
+				{
+					SUART_RxBit(ch);
+#ifdef SUART_BENCHMARK
+					bits++;
+#endif
+				}
+				if(ch->RxCnt && (int16_t)(ch->RxDue-now)<next) next=(int16_t)(ch->RxDue-now);
+			}
+			if(ch->TxOn)
+			{
+				if((int16_t)(ch->TxDue-now)<=SUART_EARLY)
+				{
+					SUART_TxBit(ch);
+#ifdef SUART_BENCHMARK
+					bits++;
+#endif
+				}
+				if(ch->TxOn && (int16_t)(ch->TxDue-now)<next) next=(int16_t)(ch->TxDue-now);
+			}
+		}
+		if(next==0x7FFF)
+		{
+			HRTIMER_TIM->IER&=(uint8_t)~SUART_CC2IE;
+			break;
+		}
+		due=now+next;
+		HRTIMER_TIM->CCR2H=(uint8_t)(due>>8);
+		HRTIMER_TIM->CCR2L=(uint8_t)due;
+		HRTIMER_TIM->IER|=SUART_CC2IE;
+	} while((int16_t)(due-HRT_Now())<=0);	/* passed while serving: once more */
+#ifdef SUART_BENCHMARK
+	t0=SUART_BenchCnt()-t0-SUART_BenchZero;
+	SUART_BenchCycles+=t0;
+	SUART_BenchBits+=bits;
+	if(t0>SUART_BenchMax) SUART_BenchMax=t0;
+#endif
+}
+
+void SUART_ExtiIRQ(GPIO_TypeDef *port)
+{
+	SUART_TypeDef *ch;
+	uint16_t now=HRT_Now();
+	uint8_t i, start=0;
+	for(i=0;i<SUART_N;i++)
+	{
+		ch=SUART_Chans[i];
+		if(ch->RxPort!=port || ch->RxCnt || !(port->CR2&ch->RxPin) || (port->IDR&ch->RxPin)) continue;
+		port->CR2&=(uint8_t)~ch->RxPin;
+		ch->RxDue=now+(ch->Bit>>1);
+		ch->RxCnt=10;
+		start=1;
+	}
+	if(start)
+	{
+		HRTIMER_TIM->IER|=SUART_CC2IE;
+		SUART_Kick();
+	}
+}
+
+/* EXTI sensitivity of port: falling edge only (EXTI_CRx is written at
+   interrupt level 3, i.e. with disabled interrupts) */
+static void SUART_ExtiFall(GPIO_TypeDef *port)
+{
+	if(port==GPIOE)
+	{
+		EXTI->CR2=(uint8_t)((EXTI->CR2&~EXTI_CR2_PEIS)|0x02);
+	}
+	else
+	{
+		uint8_t s=(port==GPIOA) ? 0 : (port==GPIOB) ? 2 : (port==GPIOC) ? 4 : 6;
+		EXTI->CR1=(uint8_t)((EXTI->CR1&~(0x03<<s))|(0x02<<s));
+	}
+}
+
+ErrorStatus SUART_Open(SUART_TypeDef *ch, uint32_t baud)
+{
+	char cc;
+	uint8_t i;
+	cc=OS_DI();
+	/* channel opened again (new baud rate or timer count) stays in list once */
+	for(i=0;i<SUART_N && SUART_Chans[i]!=ch;i++);
+	if(i==SUART_MAX_CHANNELS)
+	{
+		OS_RI(cc);
+		return ERROR;
+	}
+	ch->Bit=(uint16_t)((HRT_COUNTS_PER_S()+(baud>>1))/baud);
+	ch->TxIn=ch->TxOut=0;
+	ch->RxIn=ch->RxOut=0;
+	ch->RxErrors=0;
+	ch->TxOn=0;
+	ch->TxCnt=0;
+	ch->RxCnt=0;
+	ch->WrLeft=0;
+	ch->RdLeft=0;
+	if(!SUART_N)
+	{
+#ifdef SUART_BENCHMARK
+		SUART_BenchInit();
+#endif
+		HRTIMER_TIM->CCMR2=0;		/* channel 2: output compare, frozen, no pin */
+		HRTIMER_TIM->IER&=(uint8_t)~SUART_CC2IE;
+	}
+	if(ch->TxPort)
+	{
+		ch->TxPort->ODR|=ch->TxPin;	/* idle line is high */
+		ch->TxPort->CR1|=ch->TxPin;
+		ch->TxPort->DDR|=ch->TxPin;
+	}
+	if(ch->RxPort)
+	{
+		ch->RxPort->DDR&=(uint8_t)~ch->RxPin;
+		ch->RxPort->CR1|=ch->RxPin;	/* pull-up */
+		SUART_ExtiFall(ch->RxPort);
+		ch->RxPort->CR2|=ch->RxPin;
+	}
+	if(i==SUART_N) SUART_Chans[SUART_N++]=ch;
+	OS_RI(cc);
+	return SUCCESS;
+}
+
+uint8_t SUART_Put(SUART_TypeDef *ch, const uint8_t *buf, uint8_t len)
+{
+	uint8_t n=0, in=ch->TxIn;
+	char cc;
+	if(!ch->TxPort) return 0;
+	while(n<len && (uint8_t)(in-ch->TxOut)<=ch->TxMask)
+	{
+		ch->TxBuf[in&ch->TxMask]=buf[n++];
+		in++;
+	}
+	if(n)
+	{
+		ch->TxIn=in;
+		cc=OS_DI();
+		if(!ch->TxOn)
+		{
+			/* first start bit at once */
+			ch->TxDue=HRT_Now();
+			ch->TxOn=1;
+			HRTIMER_TIM->IER|=SUART_CC2IE;
+			SUART_Kick();
+		}
+		OS_RI(cc);
+	}
+	return n;
+}
+
+uint8_t SUART_Get(SUART_TypeDef *ch, uint8_t *buf, uint8_t len)
+{
+	uint8_t n=0, out=ch->RxOut;
+	if(!ch->RxPort) return 0;
+	while(n<len && out!=ch->RxIn)
+	{
+		buf[n++]=ch->RxBuf[out&ch->RxMask];
+		out++;
+	}
+	ch->RxOut=out;
+	return n;
+}
+
+void SUART_WriteStart(SUART_TypeDef *ch, const uint8_t *buf, uint8_t len)
+{
+	ch->WrPtr=buf;
+	ch->WrLeft=len;
+}
+
+uint8_t SUART_WriteStep(SUART_TypeDef *ch)
+{
+	uint8_t n=SUART_Put(ch, ch->WrPtr, ch->WrLeft);
+	ch->WrPtr+=n;
+	ch->WrLeft-=n;
+	return ch->WrLeft==0;
+}
+
+void SUART_ReadStart(SUART_TypeDef *ch, uint8_t *buf, uint8_t len)
+{
+	ch->RdPtr=buf;
+	ch->RdLeft=len;
+	ch->RdDone=0;
+}
+
+uint8_t SUART_ReadStep(SUART_TypeDef *ch)
+{
+	uint8_t n=SUART_Get(ch, ch->RdPtr, ch->RdLeft);
+	ch->RdPtr+=n;
+	ch->RdLeft-=n;
+	ch->RdDone+=n;
+	return ch->RdLeft==0;
+}
+#endif
@@ -434,32 +434,253 @@ void TIM4_ClearITPendingBit(TIM4_IT_TypeDef TIM4_IT)
 
 
 #ifdef __OSA__ 
-void TIM4_TimerOSA(uint16_t us)
+static uint16_t TIM4_OSA_TickUs;	/* System tick period, us */
+static uint16_t TIM4_OSA_Period;	/* TIM4 counts per system tick (ARR+1) */
+
+#ifdef OS_TIMER_BENCHMARK
+/**
+  * Benchmark of tick interrupt. Build twice (e.g. with and without
+  * OS_TIMERS_SKIP_EMPTY / OS_STIMERS_ACTIVE_LIST), run the same load and
+  * compare TIM4_OSA_Cycles and TIM4_OSA_CyclesMax in debugger.
+  * TIM1 counts fMASTER clocks without prescaler; cost of the measurement
+  * itself is measured once at start and subtracted.
+  */
+volatile uint16_t TIM4_OSA_Cycles;
+volatile uint16_t TIM4_OSA_CyclesMax;
+static uint16_t TIM4_OSA_BenchT0;
+static uint16_t TIM4_OSA_BenchZero;
+
+static uint16_t TIM4_OSA_BenchCnt(void)
+{
+	uint8_t h;
+	h = TIM1->CNTRH;	/* high byte first: low byte is latched */
+	return ((uint16_t)h << 8) | TIM1->CNTRL;
+}
+
+void TIM4_OSA_BenchStart(void)
+{
+	TIM4_OSA_BenchT0 = TIM4_OSA_BenchCnt();
+}
+
+void TIM4_OSA_BenchStop(void)
+{
+	uint16_t c;
+	c = TIM4_OSA_BenchCnt() - TIM4_OSA_BenchT0 - TIM4_OSA_BenchZero;
+	TIM4_OSA_Cycles = c;
+	if (c > TIM4_OSA_CyclesMax) TIM4_OSA_CyclesMax = c;
+}
+
+static void TIM4_OSA_BenchInit(void)
+{
+	CLK_PeripheralClockConfig(CLK_PERIPHERAL_TIMER1, ENABLE);
+	TIM1->PSCRH = 0;
+	TIM1->PSCRL = 0;
+	TIM1->ARRH = 0xFF;
+	TIM1->ARRL = 0xFF;
+	TIM1->EGR = TIM1_EGR_UG;
+	TIM1->CR1 = TIM1_CR1_CEN;
+	TIM4_OSA_BenchStart();
+	TIM4_OSA_BenchStop();
+	TIM4_OSA_BenchZero = TIM4_OSA_Cycles;
+	TIM4_OSA_Cycles = 0;
+	TIM4_OSA_CyclesMax = 0;
+}
+#endif
+
+#ifdef TIM4_OSA_FRAC
+/**
+  * Fractional tick: exact tick length is counts+rem/den timer clocks.
+  * Remainders are accumulated every tick; when sum reaches den, one period
+  * is made one count longer. ARR is preloaded, so value written in tick
+  * interrupt is used for next period. Mean tick length is exact, single
+  * tick differs by less than one timer count.
+  */
+static uint8_t  TIM4_OSA_Arr;		/* ARR for short period (counts-1) */
+static uint32_t TIM4_OSA_FracRem;	/* fractional part of tick, 1/den counts */
+static uint32_t TIM4_OSA_FracDen;
+static uint32_t TIM4_OSA_FracAcc;
+
+void TIM4_OSA_FracTick(void)
+{
+	if (!TIM4_OSA_FracRem) return;
+	TIM4_OSA_FracAcc += TIM4_OSA_FracRem;
+	if (TIM4_OSA_FracAcc >= TIM4_OSA_FracDen)
+	{
+		TIM4_OSA_FracAcc -= TIM4_OSA_FracDen;
+		TIM4->ARR = TIM4_OSA_Arr + 1;
+	}
+	else
+	{
+		TIM4->ARR = TIM4_OSA_Arr;
+	}
+}
+#endif
+
+/* counts - timer clocks per tick (1..255), rem/den - fractional part */
+static void TIM4_OSA_Start(uint8_t div, uint8_t counts, uint32_t rem, uint32_t den, uint16_t us)
 {
-	uint32_t cpu,per;
-	uint8_t div=0, ;
 	CLK_PeripheralClockConfig(CLK_PERIPHERAL_TIMER4, ENABLE);
 	TIM4_ITConfig(TIM4_IT_UPDATE, ENABLE);
-	cpu=CLK_GetClockFreq();
-	cpu/=64;
-	/*
-	while((per=cpu*us/((1<<div)*15625))>0xFF)
+	TIM4_TimeBaseInit((TIM4_Prescaler_TypeDef) div, counts - 1);
+	TIM4_OSA_TickUs = us;
+	TIM4_OSA_Period = counts;
+#ifdef TIM4_OSA_FRAC
+	TIM4_OSA_Arr = counts - 1;
+	TIM4_OSA_FracRem = rem;
+	TIM4_OSA_FracDen = den;
+	TIM4_OSA_FracAcc = 0;
+	TIM4->CR1 |= TIM4_CR1_ARPE;
+#else
+	(void)rem;
+	(void)den;
+#endif
+#ifdef OS_TIMER_BENCHMARK
+	TIM4_OSA_BenchInit();
+#endif
+	TIM4_Cmd(ENABLE);
+}
+
+/* Smallest prescaler for tick of *us at fmaster. Tick is *clk/den timer
+   clocks (clk = fmaster/64*us, den = 15625<<div). Tick longer than 255
+   clocks of prescaler 128 is cut to it (*us is changed). */
+static uint8_t TIM4_OSA_Calc(uint32_t fmaster, uint16_t *us, uint32_t *clk, uint32_t *den)
+{
+	uint8_t div=0;
+	uint32_t max;
+	fmaster/=64;
+	/* clk/(15625<<7) < 256: clk < 512000000, product does not overflow */
+	max=511999999UL/fmaster;
+	if(*us>max) *us=(uint16_t)max;
+	/* tick = fmaster*us/15625 clocks of prescaler 1 */
+	fmaster*=*us;
+	while(div<7 && fmaster/((uint32_t)15625<<div)>0xFF)
 	{
 		div++;
 	}
-	*/
-	do
+	*clk=fmaster;
+	*den=(uint32_t)15625<<div;
+	return div;
+}
+
+void TIM4_TimerOSA(uint16_t us)
+{
+	uint32_t clk,per,den;
+	uint16_t tick=us;
+	uint8_t div;
+	div=TIM4_OSA_Calc(CLK_GetClockFreq(), &tick, &clk, &den);
+	assert_param(tick==us);		/* too long for TIM4 at this fMASTER */
+	per=clk/den;
+	TIM4_OSA_Start(div, (uint8_t)per, clk-per*den, den, tick);
+}
+
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Hook for CLK_ChangeClock: keeps tick length for new fMASTER.
+  *         Counter is rescaled, so current tick keeps its phase; pending
+  *         update interrupt is not lost and no extra one is generated.
+  *         Tick too long for TIM4 at new fMASTER (255 clocks of prescaler
+  *         128) is cut to the longest one (assert_param in debug build).
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void TIM4_OSA_ClockHook(uint32_t fmaster)
+{
+	uint32_t clk,per,den;
+	uint16_t tick=TIM4_OSA_TickUs;
+	uint8_t div,cnt,uif;
+	if(!TIM4_OSA_Period) return;	/* tick is not started */
+	div=TIM4_OSA_Calc(fmaster, &tick, &clk, &den);
+	assert_param(tick==TIM4_OSA_TickUs);	/* too long for TIM4 at new fMASTER */
+	TIM4_OSA_TickUs=tick;		/* cut tick is counted by OS_GetTime_us */
+	per=clk/den;
+	if(div==TIM4->PSCR && per==TIM4_OSA_Period
+#ifdef TIM4_OSA_FRAC
+		&& den==TIM4_OSA_FracDen && clk-per*den==TIM4_OSA_FracRem
+#endif
+		) return;			/* clock is the same (CPUDIV change) */
+	cnt=TIM4->CNTR;
+	uif=TIM4->SR1 & TIM4_SR1_UIF;
+	TIM4->PSCR=div;
+	TIM4->ARR=(uint8_t)(per-1);
+	TIM4->EGR=TIM4_EGR_UG;		/* load prescaler (and preloaded ARR) now */
+	if(!uif) TIM4->SR1=(uint8_t)~TIM4_SR1_UIF;
+	TIM4->CNTR=(uint8_t)((uint16_t)cnt*(uint8_t)per/TIM4_OSA_Period);
+	TIM4_OSA_Period=(uint8_t)per;
+#ifdef TIM4_OSA_FRAC
+	TIM4_OSA_Arr=(uint8_t)(per-1);
+	TIM4_OSA_FracRem=clk-per*den;
+	TIM4_OSA_FracDen=den;
+	TIM4_OSA_FracAcc=0;
+#endif
+}
+#endif
+
+#if defined(F_CPU) && defined(TIM4_OSA_TICK_US)
+/**
+  * Same as TIM4_TimerOSA(TIM4_OSA_TICK_US), but prescaler and period are
+  * computed by compiler from F_CPU (fMASTER, Hz), e.g.
+  *   #define F_CPU            16000000UL
+  *   #define TIM4_OSA_TICK_US 1000
+  */
+#define TIM4_OSA_CLK	((F_CPU) / 64 * (TIM4_OSA_TICK_US))
+#if   TIM4_OSA_CLK / 15625 <= 0xFF
+#define TIM4_OSA_DIV	0
+#elif TIM4_OSA_CLK / (15625UL << 1) <= 0xFF
+#define TIM4_OSA_DIV	1
+#elif TIM4_OSA_CLK / (15625UL << 2) <= 0xFF
+#define TIM4_OSA_DIV	2
+#elif TIM4_OSA_CLK / (15625UL << 3) <= 0xFF
+#define TIM4_OSA_DIV	3
+#elif TIM4_OSA_CLK / (15625UL << 4) <= 0xFF
+#define TIM4_OSA_DIV	4
+#elif TIM4_OSA_CLK / (15625UL << 5) <= 0xFF
+#define TIM4_OSA_DIV	5
+#elif TIM4_OSA_CLK / (15625UL << 6) <= 0xFF
+#define TIM4_OSA_DIV	6
+#elif TIM4_OSA_CLK / (15625UL << 7) <= 0xFF
+#define TIM4_OSA_DIV	7
+#else
+#error "TIM4_OSA_TICK_US is too long for TIM4 at F_CPU"
+#endif
+#define TIM4_OSA_DEN	(15625UL << TIM4_OSA_DIV)
+
+void TIM4_TimerOSAConst(void)
+{
+	TIM4_OSA_Start(TIM4_OSA_DIV, (uint8_t)(TIM4_OSA_CLK / TIM4_OSA_DEN),
+		TIM4_OSA_CLK % TIM4_OSA_DEN, TIM4_OSA_DEN, TIM4_OSA_TICK_US);
+}
+#endif
+
+#ifdef OS_ENABLE_TIME32
+/**
+  * @brief  Microseconds since OS_Init: system ticks (OS_GetTime32) plus
+  *         current TIM4 counter. Value wraps every 2^32 us (~71 min),
+  *         use difference of two readings.
+  *         If counter has overflowed but tick interrupt is not served yet
+  *         (interrupts are disabled or this is higher priority ISR), the
+  *         pending tick is added.
+  * @param  None
+  * @retval Time in us
+  */
+uint32_t OS_GetTime_us(void)
+{
+	uint32_t ticks;
+	uint8_t cnt;
+	char cc;
+
+	cc = OS_DI();
+	ticks = _OS_Time32;
+	cnt = TIM4->CNTR;
+	if (TIM4->SR1 & TIM4_SR1_UIF)
 	{
-		per=cpu*us;
-		per/=15625;
-		per/=1<<div;
-		div++;
-	}	while(per>0xFF);
-	div--; 
-	per--;
-	TIM4_TimeBaseInit((TIM4_Prescaler_TypeDef) div, per);
-	TIM4_Cmd(ENABLE);
+		cnt = TIM4->CNTR;
+		ticks++;
+	}
+	OS_RI(cc);
+
+	return ticks * TIM4_OSA_TickUs + (uint32_t)cnt * TIM4_OSA_TickUs / TIM4_OSA_Period;
 }
+#endif
 
 #endif
 
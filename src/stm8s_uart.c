@@ -0,0 +1,402 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM8S_UART_C
+#define __STM8S_UART_C
+#include "inc/stm8s_uart.h"
+
+#ifdef UART1_BUFFERED
+#ifdef UART1_FRAME_SIZE
+UART_PORT_DEFINE_FRAME(UART_Port1, UART1, UART1_TX_SIZE, UART1_RX_SIZE, UART1_FRAME_SIZE);
+#else
+UART_PORT_DEFINE(UART_Port1, UART1, UART1_TX_SIZE, UART1_RX_SIZE);
+#endif
+#endif
+#ifdef UART2_BUFFERED
+#ifdef UART2_FRAME_SIZE
+UART_PORT_DEFINE_FRAME(UART_Port2, UART2, UART2_TX_SIZE, UART2_RX_SIZE, UART2_FRAME_SIZE);
+#else
+UART_PORT_DEFINE(UART_Port2, UART2, UART2_TX_SIZE, UART2_RX_SIZE);
+#endif
+#endif
+#ifdef UART3_BUFFERED
+#ifdef UART3_FRAME_SIZE
+UART_PORT_DEFINE_FRAME(UART_Port3, UART3, UART3_TX_SIZE, UART3_RX_SIZE, UART3_FRAME_SIZE);
+#else
+UART_PORT_DEFINE(UART_Port3, UART3, UART3_TX_SIZE, UART3_RX_SIZE);
+#endif
+#endif
+#ifdef UART4_BUFFERED
+#ifdef UART4_FRAME_SIZE
+UART_PORT_DEFINE_FRAME(UART_Port4, UART4, UART4_TX_SIZE, UART4_RX_SIZE, UART4_FRAME_SIZE);
+#else
+UART_PORT_DEFINE(UART_Port4, UART4, UART4_TX_SIZE, UART4_RX_SIZE);
+#endif
+#endif
+
+/* Task level read-modify-write of CR1, CR2 and DE port: interrupt handlers
+   change them too (TXE/TC of this port, other pins of DE port) */
+#ifdef __OSA__
+#define UART_DI(cc)     cc=OS_DI()
+#define UART_RI(cc)     OS_RI(cc)
+#else
+#define UART_DI(cc)     do { (cc)=0; disableInterrupts(); } while (0)
+#define UART_RI(cc)     do { (void)(cc); enableInterrupts(); } while (0)
+#endif
+
+static void UART_SetBaud(UART_Port_TypeDef *port, uint32_t fmaster)
+{
+	uint16_t div=(uint16_t)UART_DIV(fmaster, port->BaudRate);
+	UART_SET_DIV(port->Regs, div);
+}
+
+void UART_BufInit(UART_Port_TypeDef *port)
+{
+	char cc;
+	UART_DI(cc);
+	port->Regs->CR2&=(uint8_t)~(UART_CR2_TIEN|UART_CR2_TCIEN|UART_CR2_RIEN);
+	port->TxIn=port->TxOut=0;
+	port->RxIn=port->RxOut=0;
+	port->RxOverflow=0;
+	port->WrLeft=0;
+	port->RdLeft=0;
+	port->IovBusy=0;
+	port->IovSent=0;
+	port->AddrPending=0;
+	port->Regs->CR2|=UART_CR2_RIEN;
+	UART_RI(cc);
+}
+
+void UART_OpenDiv(UART_Port_TypeDef *port, uint32_t baud, uint16_t div, uint8_t format)
+{
+	UART_Regs_TypeDef *r=port->Regs;
+	char cc;
+	r->CR2=0;
+	r->CR1=(uint8_t)(format&(UART_CR1_M|UART_CR1_PCEN|UART_CR1_PS));
+	r->CR3=(format&UART_STOPBITS_2) ? UART_CR3_STOP2 : 0;
+	port->BaudRate=baud;
+	UART_SET_DIV(r, div);
+	UART_BufInit(port);
+	UART_DI(cc);
+	r->CR2|=UART_CR2_TEN|UART_CR2_REN;
+	UART_RI(cc);
+}
+
+void UART_Open(UART_Port_TypeDef *port, uint32_t baud, uint8_t format)
+{
+	uint32_t f=CLK_GetClockFreq();
+	UART_OpenDiv(port, baud, (uint16_t)UART_DIV(f, baud), format);
+}
+
+uint8_t UART_Put(UART_Port_TypeDef *port, const uint8_t *buf, uint8_t len)
+{
+	uint8_t n=0, in=port->TxIn;
+	char cc;
+	while(n<len && (uint8_t)(in-port->TxOut)<=port->TxMask)
+	{
+		port->TxBuf[in&port->TxMask]=buf[n++];
+		in++;
+	}
+	if(n)
+	{
+		port->TxIn=in;
+		UART_DI(cc);
+		if(port->DePort) port->DePort->ODR|=port->DePin;
+		/* after end of list ring waits for its TC */
+		if(!port->IovSent) port->Regs->CR2|=UART_CR2_TIEN;
+		UART_RI(cc);
+	}
+	return n;
+}
+
+uint8_t UART_Get(UART_Port_TypeDef *port, uint8_t *buf, uint8_t len)
+{
+	uint8_t n=0, out=port->RxOut;
+	while(n<len && out!=port->RxIn)
+	{
+		buf[n++]=port->RxBuf[out&port->RxMask];
+		out++;
+	}
+	port->RxOut=out;
+	return n;
+}
+
+uint8_t UART_RxCount(UART_Port_TypeDef *port)
+{
+	return (uint8_t)(port->RxIn-port->RxOut);
+}
+
+uint8_t UART_TxIdle(UART_Port_TypeDef *port)
+{
+	return port->TxIn==port->TxOut && (port->Regs->SR&UART_SR_TC);
+}
+
+void UART_WriteStart(UART_Port_TypeDef *port, const uint8_t *buf, uint8_t len)
+{
+	port->WrPtr=buf;
+	port->WrLeft=len;
+}
+
+uint8_t UART_WriteStep(UART_Port_TypeDef *port)
+{
+	uint8_t n=UART_Put(port, port->WrPtr, port->WrLeft);
+	port->WrPtr+=n;
+	port->WrLeft-=n;
+	return port->WrLeft==0;
+}
+
+void UART_ReadStart(UART_Port_TypeDef *port, uint8_t *buf, uint8_t len)
+{
+	port->RdPtr=buf;
+	port->RdLeft=len;
+	port->RdDone=0;
+}
+
+uint8_t UART_ReadStep(UART_Port_TypeDef *port)
+{
+	uint8_t n=UART_Get(port, port->RdPtr, port->RdLeft);
+	port->RdPtr+=n;
+	port->RdLeft-=n;
+	port->RdDone+=n;
+	return port->RdLeft==0;
+}
+
+uint8_t UART_ReadDone(UART_Port_TypeDef *port)
+{
+	return port->RdDone;
+}
+
+/* Called with disabled interrupts: TC interrupt of previous list may clear
+   IovBusy and change CR2 meanwhile */
+static void UART_Submit(UART_Port_TypeDef *port, const UART_Iov_TypeDef *iov,
+                        uint8_t n, UART_Done_TypeDef done)
+{
+	port->Iov=iov;
+	port->IovN=n;
+	port->IovLeft=0;
+	port->IovDone=done;
+	port->IovMark=port->TxIn;
+	port->IovSent=0;
+	port->IovBusy=1;
+	if(port->DePort) port->DePort->ODR|=port->DePin;
+	port->Regs->CR2|=UART_CR2_TIEN;
+}
+
+ErrorStatus UART_TxSubmit(UART_Port_TypeDef *port, const UART_Iov_TypeDef *iov,
+                          uint8_t n, UART_Done_TypeDef done)
+{
+	char cc;
+	UART_DI(cc);
+	if(port->IovBusy)
+	{
+		UART_RI(cc);
+		return ERROR;
+	}
+	UART_Submit(port, iov, n, done);
+	UART_RI(cc);
+	return SUCCESS;
+}
+
+void UART_Rs485Open(UART_Port_TypeDef *port, uint32_t baud, uint8_t addr,
+                    GPIO_TypeDef *deport, uint8_t depin)
+{
+	UART_Regs_TypeDef *r=port->Regs;
+	char cc;
+	port->DePort=deport;
+	port->DePin=depin;
+	if(deport)
+	{
+		UART_DI(cc);
+		deport->ODR&=(uint8_t)~depin;
+		deport->CR1|=depin;		/* push-pull */
+		deport->DDR|=depin;
+		UART_RI(cc);
+	}
+	port->Addr=addr;
+	UART_Open(port, baud, UART_CR1_M);	/* 8 data bits + address mark */
+	UART_DI(cc);
+	r->CR1|=UART_CR1_WAKE;
+	r->CR4=(uint8_t)((r->CR4&(uint8_t)~UART_CR4_ADD)|(addr&UART_CR4_ADD));
+	r->CR2|=UART_CR2_RWU;
+	UART_RI(cc);
+}
+
+ErrorStatus UART_Rs485Send(UART_Port_TypeDef *port, uint8_t addr,
+                           const UART_Iov_TypeDef *iov, uint8_t n, UART_Done_TypeDef done)
+{
+	char cc;
+	UART_DI(cc);
+	if(port->IovBusy)
+	{
+		UART_RI(cc);
+		return ERROR;
+	}
+	port->AddrByte=addr;
+	port->AddrPending=1;
+	UART_Submit(port, iov, n, done);
+	UART_RI(cc);
+	return SUCCESS;
+}
+
+/* Next byte of segment list; 0 if list is over */
+static uint8_t UART_IovNext(UART_Port_TypeDef *port, uint8_t *d)
+{
+	while(!port->IovLeft)
+	{
+		if(!port->IovN) return 0;
+		port->IovN--;
+		port->IovPtr=port->Iov->Data;
+		port->IovLeft=port->Iov->Len;
+		port->Iov++;
+	}
+	port->IovLeft--;
+	*d=*port->IovPtr++;
+	return 1;
+}
+
+void UART_TxIRQ(UART_Port_TypeDef *port)
+{
+	uint8_t out=port->TxOut, d, sr;
+	sr=port->Regs->SR;	/* SR then DR: clears TC */
+	if((port->Regs->CR2&UART_CR2_TCIEN) && (sr&UART_SR_TC))
+	{
+		/* last byte has left shift register */
+		port->Regs->CR2&=(uint8_t)~UART_CR2_TCIEN;
+		if(port->IovSent)
+		{
+			port->IovSent=0;
+			port->IovBusy=0;
+			if(port->IovDone) port->IovDone(port);
+			/* ring bytes put after list */
+			if(port->TxOut!=port->TxIn) port->Regs->CR2|=UART_CR2_TIEN;
+		}
+		/* RS-485: nothing more to send - free the bus */
+		if(port->DePort && !port->IovBusy && out==port->TxIn)
+		{
+			port->DePort->ODR&=(uint8_t)~port->DePin;
+		}
+	}
+	if(!(port->Regs->CR2&UART_CR2_TIEN) || !(sr&UART_SR_TXE)) return;
+	/* previous byte is in shift register already, 9th bit may be changed */
+	port->Regs->CR1&=(uint8_t)~UART_CR1_T8;
+	if(port->IovBusy && out==port->IovMark && !port->IovSent)
+	{
+		if(port->AddrPending)
+		{
+			port->AddrPending=0;
+			port->Regs->CR1|=UART_CR1_T8;
+			port->Regs->DR=port->AddrByte;
+			return;
+		}
+		if(UART_IovNext(port, &d))
+		{
+			port->Regs->DR=d;
+			if(!port->IovLeft && !port->IovN)
+			{
+				port->IovSent=1;
+				port->Regs->CR2=(uint8_t)((port->Regs->CR2&~UART_CR2_TIEN)|UART_CR2_TCIEN);
+			}
+			return;
+		}
+		/* empty list */
+		port->IovSent=1;
+		port->Regs->CR2=(uint8_t)((port->Regs->CR2&~UART_CR2_TIEN)|UART_CR2_TCIEN);
+		return;
+	}
+	if(out==port->TxIn)
+	{
+		port->Regs->CR2&=(uint8_t)~UART_CR2_TIEN;
+		if(port->DePort) port->Regs->CR2|=UART_CR2_TCIEN;
+		return;
+	}
+	port->Regs->DR=port->TxBuf[out&port->TxMask];
+	port->TxOut=out+1;
+}
+
+/* Frame mode: byte to current frame buffer, on idle line frame is ready */
+static void UART_FrameIRQ(UART_Port_TypeDef *port, uint8_t sr, uint8_t d)
+{
+	if((sr&UART_SR_RXNE) && port->FrameIdx<port->FrameSize)
+	{
+		port->FrameBuf[(port->FrameCur ? port->FrameSize : 0)+port->FrameIdx++]=d;
+	}
+	if((sr&UART_SR_IDLE) && port->FrameIdx)
+	{
+		if(port->FrameLen)
+		{
+			port->FrameLost++;	/* task still has previous frame */
+		}
+		else
+		{
+			port->FrameReady=port->FrameCur;
+			port->FrameCur^=1;
+			port->FrameLen=port->FrameIdx;
+		}
+		port->FrameIdx=0;
+	}
+}
+
+void UART_FrameMode(UART_Port_TypeDef *port, FunctionalState NewState)
+{
+	char cc;
+	UART_DI(cc);
+	port->Regs->CR2&=(uint8_t)~UART_CR2_ILIEN;
+	port->FrameMode=0;
+	port->FrameIdx=0;
+	port->FrameLen=0;
+	port->FrameLost=0;
+	if(NewState!=DISABLE && port->FrameBuf)
+	{
+		port->FrameMode=1;
+		port->Regs->CR2|=UART_CR2_ILIEN;
+	}
+	UART_RI(cc);
+}
+
+void UART_FrameRelease(UART_Port_TypeDef *port)
+{
+	port->FrameLen=0;
+}
+
+void UART_RxIRQ(UART_Port_TypeDef *port)
+{
+	uint8_t in=port->RxIn, d, sr, cr1;
+	sr=port->Regs->SR;	/* SR then DR: clears RXNE, IDLE and error flags */
+	cr1=port->Regs->CR1;	/* R8 before DR */
+	d=port->Regs->DR;
+	if((cr1&(UART_CR1_WAKE|UART_CR1_R8))==(UART_CR1_WAKE|UART_CR1_R8) && (sr&UART_SR_RXNE))
+	{
+		/* address byte: hardware has compared low 4 bits only */
+		if(d!=port->Addr) port->Regs->CR2|=UART_CR2_RWU;
+		return;
+	}
+	if(port->FrameMode)
+	{
+		UART_FrameIRQ(port, sr, d);
+		return;
+	}
+	if((uint8_t)(in-port->RxOut)>port->RxMask)
+	{
+		port->RxOverflow=1;
+		return;
+	}
+	port->RxBuf[in&port->RxMask]=d;
+	port->RxIn=in+1;
+}
+
+#ifdef CLK_ChangeClock_Def
+void UART_ClockHook(uint32_t fmaster)
+{
+#ifdef UART1_BUFFERED
+	if(UART_Port1.BaudRate) UART_SetBaud(&UART_Port1, fmaster);
+#endif
+#ifdef UART2_BUFFERED
+	if(UART_Port2.BaudRate) UART_SetBaud(&UART_Port2, fmaster);
+#endif
+#ifdef UART3_BUFFERED
+	if(UART_Port3.BaudRate) UART_SetBaud(&UART_Port3, fmaster);
+#endif
+#ifdef UART4_BUFFERED
+	if(UART_Port4.BaudRate) UART_SetBaud(&UART_Port4, fmaster);
+#endif
+}
+#endif
+#endif
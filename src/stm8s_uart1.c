@@ -70,31 +70,24 @@ void UART1_DeInit(void)
   UART1->PSCR = UART1_PSCR_RESET_VALUE;
 }
 
+#ifdef CLK_ChangeClock_Def
+static uint32_t UART1_BaudRate;	/* saved by UART1_Init for clock change */
+#endif
+
 /**
-  * @brief  Initializes the UART1 according to the specified parameters.
-  * @note   Configure in Push Pull or Open Drain mode the Tx pin by setting the
-  *         correct I/O Port register according the product package and line
-  *         configuration
-  * @param  BaudRate: The baudrate.
-  * @param  WordLength : This parameter can be any of the 
-  *         @ref UART1_WordLength_TypeDef enumeration.
-  * @param  StopBits: This parameter can be any of the 
-  *         @ref UART1_StopBits_TypeDef enumeration.
-  * @param  Parity: This parameter can be any of the 
-  *         @ref UART1_Parity_TypeDef enumeration.
-  * @param  SyncMode: This parameter can be any of the 
-  *         @ref UART1_SyncMode_TypeDef values.
-  * @param  Mode: This parameter can be any of the @ref UART1_Mode_TypeDef values
+  * @brief  Frame format, mode and baud rate registers of UART1_Init.
+  * @param  BRR1, BRR2: values of baud rate registers.
+  * @param  WordLength, StopBits, Parity, SyncMode, Mode: as in UART1_Init.
   * @retval None
   */
-void UART1_Init(uint32_t BaudRate, UART1_WordLength_TypeDef WordLength, 
-                UART1_StopBits_TypeDef StopBits, UART1_Parity_TypeDef Parity, 
-                UART1_SyncMode_TypeDef SyncMode, UART1_Mode_TypeDef Mode)
+static void UART1_Config(uint8_t BRR1, uint8_t BRR2,
+                         UART1_WordLength_TypeDef WordLength,
+                         UART1_StopBits_TypeDef StopBits,
+                         UART1_Parity_TypeDef Parity,
+                         UART1_SyncMode_TypeDef SyncMode,
+                         UART1_Mode_TypeDef Mode)
 {
-  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
-  
   /* Check the parameters */
-  assert_param(IS_UART1_BAUDRATE_OK(BaudRate));
   assert_param(IS_UART1_WORDLENGTH_OK(WordLength));
   assert_param(IS_UART1_STOPBITS_OK(StopBits));
   assert_param(IS_UART1_PARITY_OK(Parity));
@@ -117,22 +110,10 @@ void UART1_Init(uint32_t BaudRate, UART1_WordLength_TypeDef WordLength,
   /* Set the Parity Control bit to UART1_Parity value */
   UART1->CR1 |= (uint8_t)Parity;  
   
-  /* Clear the LSB mantissa of UART1DIV  */
-  UART1->BRR1 &= (uint8_t)(~UART1_BRR1_DIVM);  
-  /* Clear the MSB mantissa of UART1DIV  */
-  UART1->BRR2 &= (uint8_t)(~UART1_BRR2_DIVM);  
-  /* Clear the Fraction bits of UART1DIV */
-  UART1->BRR2 &= (uint8_t)(~UART1_BRR2_DIVF);  
-  
-  /* Set the UART1 BaudRates in BRR1 and BRR2 registers according to UART1_BaudRate value */
-  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
-  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
-  /* Set the fraction of UART1DIV  */
-  UART1->BRR2 |= (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100)) << 4) / 100) & (uint8_t)0x0F); 
-  /* Set the MSB mantissa of UART1DIV  */
-  UART1->BRR2 |= (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0); 
-  /* Set the LSB mantissa of UART1DIV  */
-  UART1->BRR1 |= (uint8_t)BaudRate_Mantissa;           
+  /* The fraction and MSB mantissa should be loaded in one step in the BRR2 register */
+  UART1->BRR2 = BRR2;
+  /* Set the LSB mantissa of UART1DIV, it updates the divider */
+  UART1->BRR1 = BRR1;
   
   /* Disable the Transmitter and Receiver before setting the LBCL, CPOL and CPHA bits */
   UART1->CR2 &= (uint8_t)~(UART1_CR2_TEN | UART1_CR2_REN); 
@@ -175,6 +156,85 @@ void UART1_Init(uint32_t BaudRate, UART1_WordLength_TypeDef WordLength,
   }
 }
 
+/**
+  * @brief  Initializes the UART1 according to the specified parameters.
+  * @note   Configure in Push Pull or Open Drain mode the Tx pin by setting the
+  *         correct I/O Port register according the product package and line
+  *         configuration
+  * @param  BaudRate: The baudrate.
+  * @param  WordLength : This parameter can be any of the 
+  *         @ref UART1_WordLength_TypeDef enumeration.
+  * @param  StopBits: This parameter can be any of the 
+  *         @ref UART1_StopBits_TypeDef enumeration.
+  * @param  Parity: This parameter can be any of the 
+  *         @ref UART1_Parity_TypeDef enumeration.
+  * @param  SyncMode: This parameter can be any of the 
+  *         @ref UART1_SyncMode_TypeDef values.
+  * @param  Mode: This parameter can be any of the @ref UART1_Mode_TypeDef values
+  * @retval None
+  */
+void UART1_Init(uint32_t BaudRate, UART1_WordLength_TypeDef WordLength, 
+                UART1_StopBits_TypeDef StopBits, UART1_Parity_TypeDef Parity, 
+                UART1_SyncMode_TypeDef SyncMode, UART1_Mode_TypeDef Mode)
+{
+  uint8_t BRR2_1 = 0, BRR2_2 = 0;
+  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
+  
+  /* Check the parameters */
+  assert_param(IS_UART1_BAUDRATE_OK(BaudRate));
+  
+  /* Set the UART1 BaudRates in BRR1 and BRR2 registers according to UART1_BaudRate value */
+#ifdef CLK_ChangeClock_Def
+  UART1_BaudRate = BaudRate;
+#endif
+  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
+  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
+  /* Set the fraction of UARTDIV  */
+  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
+                                << 4) / 100) & (uint8_t)0x0F); 
+  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
+  
+  UART1_Config((uint8_t)BaudRate_Mantissa, (uint8_t)(BRR2_1 | BRR2_2),
+               WordLength, StopBits, Parity, SyncMode, Mode);
+}
+
+#if defined(F_CPU) && defined(UART1_BAUD)
+/**
+  * @brief  Same as UART1_Init(UART1_BAUD, ...), but baud rate registers are
+  *         computed by compiler from F_CPU (see stm8s_baud.h): no 32-bit
+  *         division at run time.
+  * @param  WordLength, StopBits, Parity, SyncMode, Mode: as in UART1_Init.
+  * @retval None
+  */
+void UART1_InitConst(UART1_WordLength_TypeDef WordLength,
+                     UART1_StopBits_TypeDef StopBits,
+                     UART1_Parity_TypeDef Parity,
+                     UART1_SyncMode_TypeDef SyncMode, UART1_Mode_TypeDef Mode)
+{
+#ifdef CLK_ChangeClock_Def
+  UART1_BaudRate = UART1_BAUD;
+#endif
+  UART1_Config(UART_BRR1(UART1_DIV), UART_BRR2(UART1_DIV),
+               WordLength, StopBits, Parity, SyncMode, Mode);
+}
+#endif
+
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Recalculates BRR for new fMASTER (hook for CLK_ChangeClock).
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void UART1_ClockHook(uint32_t fmaster)
+{
+  uint32_t div;
+
+  if (!UART1_BaudRate) return;
+  div = UART_DIV(fmaster, UART1_BaudRate);
+  UART_SET_DIV(UART1, div);
+}
+#endif
+
 /**
   * @brief  Enable the UART1 peripheral.
   * @param  NewState : The new state of the UART Communication.
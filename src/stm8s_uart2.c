@@ -68,27 +68,24 @@ void UART2_DeInit(void)
   UART2->CR6 = UART2_CR6_RESET_VALUE; /*  Set UART2_CR6 to reset value 0x00  */
 }
 
+#ifdef CLK_ChangeClock_Def
+static uint32_t UART2_BaudRate;	/* saved by UART2_Init for clock change */
+#endif
+
 /**
-  * @brief  Initializes the UART2 according to the specified parameters.
-  * @param  BaudRate: The baudrate.
-  * @param  WordLength : This parameter can be any of the 
-  *         @ref UART2_WordLength_TypeDef enumeration.
-  * @param  StopBits: This parameter can be any of the 
-  *         @ref UART2_StopBits_TypeDef enumeration.
-  * @param  Parity: This parameter can be any of the 
-  *         @ref UART2_Parity_TypeDef enumeration.
-  * @param  SyncMode: This parameter can be any of the 
-  *         @ref UART2_SyncMode_TypeDef values.
-  * @param  Mode: This parameter can be any of the @ref UART2_Mode_TypeDef values
+  * @brief  Frame format, mode and baud rate registers of UART2_Init.
+  * @param  BRR1, BRR2: values of baud rate registers.
+  * @param  WordLength, StopBits, Parity, SyncMode, Mode: as in UART2_Init.
   * @retval None
   */
-void UART2_Init(uint32_t BaudRate, UART2_WordLength_TypeDef WordLength, UART2_StopBits_TypeDef StopBits, UART2_Parity_TypeDef Parity, UART2_SyncMode_TypeDef SyncMode, UART2_Mode_TypeDef Mode)
+static void UART2_Config(uint8_t BRR1, uint8_t BRR2,
+                         UART2_WordLength_TypeDef WordLength,
+                         UART2_StopBits_TypeDef StopBits,
+                         UART2_Parity_TypeDef Parity,
+                         UART2_SyncMode_TypeDef SyncMode,
+                         UART2_Mode_TypeDef Mode)
 {
-  uint8_t BRR2_1 = 0, BRR2_2 = 0;
-  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
-  
   /* Check the parameters */
-  assert_param(IS_UART2_BAUDRATE_OK(BaudRate));
   assert_param(IS_UART2_WORDLENGTH_OK(WordLength));
   assert_param(IS_UART2_STOPBITS_OK(StopBits));
   assert_param(IS_UART2_PARITY_OK(Parity));
@@ -110,26 +107,10 @@ void UART2_Init(uint32_t BaudRate, UART2_WordLength_TypeDef WordLength, UART2_St
   /* Set the Parity Control bit to UART2_Parity value */
   UART2->CR1 |= (uint8_t)Parity;
   
-  /* Clear the LSB mantissa of UART2DIV  */
-  UART2->BRR1 &= (uint8_t)(~UART2_BRR1_DIVM);
-  /* Clear the MSB mantissa of UART2DIV  */
-  UART2->BRR2 &= (uint8_t)(~UART2_BRR2_DIVM);
-  /* Clear the Fraction bits of UART2DIV */
-  UART2->BRR2 &= (uint8_t)(~UART2_BRR2_DIVF);
-  
-  /* Set the UART2 BaudRates in BRR1 and BRR2 registers according to UART2_BaudRate value */
-  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
-  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
-  
-  /* The fraction and MSB mantissa should be loaded in one step in the BRR2 register*/
-  /* Set the fraction of UARTDIV  */
-  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
-                                << 4) / 100) & (uint8_t)0x0F); 
-  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
-  
-  UART2->BRR2 = (uint8_t)(BRR2_1 | BRR2_2);
-  /* Set the LSB mantissa of UARTDIV  */
-  UART2->BRR1 = (uint8_t)BaudRate_Mantissa;           
+  /* The fraction and MSB mantissa should be loaded in one step in the BRR2 register */
+  UART2->BRR2 = BRR2;
+  /* Set the LSB mantissa of UART2DIV, it updates the divider */
+  UART2->BRR1 = BRR1;
   
   /* Disable the Transmitter and Receiver before setting the LBCL, CPOL and CPHA bits */
   UART2->CR2 &= (uint8_t)~(UART2_CR2_TEN | UART2_CR2_REN);
@@ -172,6 +153,80 @@ void UART2_Init(uint32_t BaudRate, UART2_WordLength_TypeDef WordLength, UART2_St
   }
 }
 
+/**
+  * @brief  Initializes the UART2 according to the specified parameters.
+  * @param  BaudRate: The baudrate.
+  * @param  WordLength : This parameter can be any of the 
+  *         @ref UART2_WordLength_TypeDef enumeration.
+  * @param  StopBits: This parameter can be any of the 
+  *         @ref UART2_StopBits_TypeDef enumeration.
+  * @param  Parity: This parameter can be any of the 
+  *         @ref UART2_Parity_TypeDef enumeration.
+  * @param  SyncMode: This parameter can be any of the 
+  *         @ref UART2_SyncMode_TypeDef values.
+  * @param  Mode: This parameter can be any of the @ref UART2_Mode_TypeDef values
+  * @retval None
+  */
+void UART2_Init(uint32_t BaudRate, UART2_WordLength_TypeDef WordLength, UART2_StopBits_TypeDef StopBits, UART2_Parity_TypeDef Parity, UART2_SyncMode_TypeDef SyncMode, UART2_Mode_TypeDef Mode)
+{
+  uint8_t BRR2_1 = 0, BRR2_2 = 0;
+  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
+  
+  /* Check the parameters */
+  assert_param(IS_UART2_BAUDRATE_OK(BaudRate));
+  
+  /* Set the UART2 BaudRates in BRR1 and BRR2 registers according to UART2_BaudRate value */
+#ifdef CLK_ChangeClock_Def
+  UART2_BaudRate = BaudRate;
+#endif
+  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
+  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
+  /* Set the fraction of UARTDIV  */
+  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
+                                << 4) / 100) & (uint8_t)0x0F); 
+  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
+  
+  UART2_Config((uint8_t)BaudRate_Mantissa, (uint8_t)(BRR2_1 | BRR2_2),
+               WordLength, StopBits, Parity, SyncMode, Mode);
+}
+
+#if defined(F_CPU) && defined(UART2_BAUD)
+/**
+  * @brief  Same as UART2_Init(UART2_BAUD, ...), but baud rate registers are
+  *         computed by compiler from F_CPU (see stm8s_baud.h): no 32-bit
+  *         division at run time.
+  * @param  WordLength, StopBits, Parity, SyncMode, Mode: as in UART2_Init.
+  * @retval None
+  */
+void UART2_InitConst(UART2_WordLength_TypeDef WordLength,
+                     UART2_StopBits_TypeDef StopBits,
+                     UART2_Parity_TypeDef Parity,
+                     UART2_SyncMode_TypeDef SyncMode, UART2_Mode_TypeDef Mode)
+{
+#ifdef CLK_ChangeClock_Def
+  UART2_BaudRate = UART2_BAUD;
+#endif
+  UART2_Config(UART_BRR1(UART2_DIV), UART_BRR2(UART2_DIV),
+               WordLength, StopBits, Parity, SyncMode, Mode);
+}
+#endif
+
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Recalculates BRR for new fMASTER (hook for CLK_ChangeClock).
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void UART2_ClockHook(uint32_t fmaster)
+{
+  uint32_t div;
+
+  if (!UART2_BaudRate) return;
+  div = UART_DIV(fmaster, UART2_BaudRate);
+  UART_SET_DIV(UART2, div);
+}
+#endif
+
 /**
   * @brief  Enable the UART2 peripheral.
   * @param  NewState : The new state of the UART Communication.
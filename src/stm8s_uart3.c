@@ -68,30 +68,25 @@ void UART3_DeInit(void)
   UART3->CR6 = UART3_CR6_RESET_VALUE;  /*Set UART3_CR6 to reset value 0x00  */
 }
 
+#ifdef CLK_ChangeClock_Def
+static uint32_t UART3_BaudRate;	/* saved by UART3_Init for clock change */
+#endif
+
 /**
-  * @brief  Initializes the UART3 according to the specified parameters.
-  * @param  BaudRate: The baudrate.
-  * @param  WordLength : This parameter can be any of 
-  *         the @ref UART3_WordLength_TypeDef enumeration.
-  * @param  StopBits: This parameter can be any of the 
-  *         @ref UART3_StopBits_TypeDef enumeration.
-  * @param  Parity: This parameter can be any of the 
-  *         @ref UART3_Parity_TypeDef enumeration.
-  * @param  Mode: This parameter can be any of the @ref UART3_Mode_TypeDef values
+  * @brief  Frame format, mode and baud rate registers of UART3_Init.
+  * @param  BRR1, BRR2: values of baud rate registers.
+  * @param  WordLength, StopBits, Parity, Mode: as in UART3_Init.
   * @retval None
   */
-void UART3_Init(uint32_t BaudRate, UART3_WordLength_TypeDef WordLength, 
-                UART3_StopBits_TypeDef StopBits, UART3_Parity_TypeDef Parity, 
-                UART3_Mode_TypeDef Mode)
+static void UART3_Config(uint8_t BRR1, uint8_t BRR2,
+                         UART3_WordLength_TypeDef WordLength,
+                         UART3_StopBits_TypeDef StopBits,
+                         UART3_Parity_TypeDef Parity, UART3_Mode_TypeDef Mode)
 {
-  uint8_t BRR2_1 = 0, BRR2_2 = 0;
-  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
-  
   /* Check the parameters */
   assert_param(IS_UART3_WORDLENGTH_OK(WordLength));
   assert_param(IS_UART3_STOPBITS_OK(StopBits));
   assert_param(IS_UART3_PARITY_OK(Parity));
-  assert_param(IS_UART3_BAUDRATE_OK(BaudRate));
   assert_param(IS_UART3_MODE_OK((uint8_t)Mode));
   
   /* Clear the word length bit */
@@ -109,25 +104,10 @@ void UART3_Init(uint32_t BaudRate, UART3_WordLength_TypeDef WordLength,
   /* Set the Parity Control bit to UART3_Parity value */
   UART3->CR1 |= (uint8_t)Parity;     
   
-  /* Clear the LSB mantissa of UART3DIV  */
-  UART3->BRR1 &= (uint8_t)(~UART3_BRR1_DIVM);  
-  /* Clear the MSB mantissa of UART3DIV  */
-  UART3->BRR2 &= (uint8_t)(~UART3_BRR2_DIVM);  
-  /* Clear the Fraction bits of UART3DIV */
-  UART3->BRR2 &= (uint8_t)(~UART3_BRR2_DIVF);  
-  
-  /* Set the UART3 BaudRates in BRR1 and BRR2 registers according to UART3_BaudRate value */
-  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
-  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
   /* The fraction and MSB mantissa should be loaded in one step in the BRR2 register */
-  /* Set the fraction of UART3DIV  */
-  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
-                                << 4) / 100) & (uint8_t)0x0F); 
-  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
-  
-  UART3->BRR2 = (uint8_t)(BRR2_1 | BRR2_2);
-  /* Set the LSB mantissa of UART3DIV  */
-  UART3->BRR1 = (uint8_t)BaudRate_Mantissa;           
+  UART3->BRR2 = BRR2;
+  /* Set the LSB mantissa of UART3DIV, it updates the divider */
+  UART3->BRR1 = BRR1;
   
   if ((uint8_t)(Mode & UART3_MODE_TX_ENABLE))
   {
@@ -151,6 +131,79 @@ void UART3_Init(uint32_t BaudRate, UART3_WordLength_TypeDef WordLength,
   }
 }
 
+/**
+  * @brief  Initializes the UART3 according to the specified parameters.
+  * @param  BaudRate: The baudrate.
+  * @param  WordLength : This parameter can be any of 
+  *         the @ref UART3_WordLength_TypeDef enumeration.
+  * @param  StopBits: This parameter can be any of the 
+  *         @ref UART3_StopBits_TypeDef enumeration.
+  * @param  Parity: This parameter can be any of the 
+  *         @ref UART3_Parity_TypeDef enumeration.
+  * @param  Mode: This parameter can be any of the @ref UART3_Mode_TypeDef values
+  * @retval None
+  */
+void UART3_Init(uint32_t BaudRate, UART3_WordLength_TypeDef WordLength, 
+                UART3_StopBits_TypeDef StopBits, UART3_Parity_TypeDef Parity, 
+                UART3_Mode_TypeDef Mode)
+{
+  uint8_t BRR2_1 = 0, BRR2_2 = 0;
+  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
+  
+  /* Check the parameters */
+  assert_param(IS_UART3_BAUDRATE_OK(BaudRate));
+  
+  /* Set the UART3 BaudRates in BRR1 and BRR2 registers according to UART3_BaudRate value */
+#ifdef CLK_ChangeClock_Def
+  UART3_BaudRate = BaudRate;
+#endif
+  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
+  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
+  /* Set the fraction of UARTDIV  */
+  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
+                                << 4) / 100) & (uint8_t)0x0F); 
+  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
+  
+  UART3_Config((uint8_t)BaudRate_Mantissa, (uint8_t)(BRR2_1 | BRR2_2),
+               WordLength, StopBits, Parity, Mode);
+}
+
+#if defined(F_CPU) && defined(UART3_BAUD)
+/**
+  * @brief  Same as UART3_Init(UART3_BAUD, ...), but baud rate registers are
+  *         computed by compiler from F_CPU (see stm8s_baud.h): no 32-bit
+  *         division at run time.
+  * @param  WordLength, StopBits, Parity, Mode: as in UART3_Init.
+  * @retval None
+  */
+void UART3_InitConst(UART3_WordLength_TypeDef WordLength,
+                     UART3_StopBits_TypeDef StopBits,
+                     UART3_Parity_TypeDef Parity, UART3_Mode_TypeDef Mode)
+{
+#ifdef CLK_ChangeClock_Def
+  UART3_BaudRate = UART3_BAUD;
+#endif
+  UART3_Config(UART_BRR1(UART3_DIV), UART_BRR2(UART3_DIV),
+               WordLength, StopBits, Parity, Mode);
+}
+#endif
+
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Recalculates BRR for new fMASTER (hook for CLK_ChangeClock).
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void UART3_ClockHook(uint32_t fmaster)
+{
+  uint32_t div;
+
+  if (!UART3_BaudRate) return;
+  div = UART_DIV(fmaster, UART3_BaudRate);
+  UART_SET_DIV(UART3, div);
+}
+#endif
+
 /**
   * @brief  Enable the UART1 peripheral.
   * @param  NewState : The new state of the UART Communication.
@@ -68,27 +68,24 @@ void UART4_DeInit(void)
   UART4->CR6 = UART4_CR6_RESET_VALUE; /*  Set UART4_CR6 to reset value 0x00  */
 }
 
+#ifdef CLK_ChangeClock_Def
+static uint32_t UART4_BaudRate;	/* saved by UART4_Init for clock change */
+#endif
+
 /**
-  * @brief  Initializes the UART4 according to the specified parameters.
-  * @param  BaudRate: The baudrate.
-  * @param  WordLength : This parameter can be any of the 
-  *         @ref UART4_WordLength_TypeDef enumeration.
-  * @param  StopBits: This parameter can be any of the 
-  *         @ref UART4_StopBits_TypeDef enumeration.
-  * @param  Parity: This parameter can be any of the 
-  *         @ref UART4_Parity_TypeDef enumeration.
-  * @param  SyncMode: This parameter can be any of the 
-  *         @ref UART4_SyncMode_TypeDef values.
-  * @param  Mode: This parameter can be any of the @ref UART4_Mode_TypeDef values
+  * @brief  Frame format, mode and baud rate registers of UART4_Init.
+  * @param  BRR1, BRR2: values of baud rate registers.
+  * @param  WordLength, StopBits, Parity, SyncMode, Mode: as in UART4_Init.
   * @retval None
   */
-void UART4_Init(uint32_t BaudRate, UART4_WordLength_TypeDef WordLength, UART4_StopBits_TypeDef StopBits, UART4_Parity_TypeDef Parity, UART4_SyncMode_TypeDef SyncMode, UART4_Mode_TypeDef Mode)
+static void UART4_Config(uint8_t BRR1, uint8_t BRR2,
+                         UART4_WordLength_TypeDef WordLength,
+                         UART4_StopBits_TypeDef StopBits,
+                         UART4_Parity_TypeDef Parity,
+                         UART4_SyncMode_TypeDef SyncMode,
+                         UART4_Mode_TypeDef Mode)
 {
-  uint8_t BRR2_1 = 0, BRR2_2 = 0;
-  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
-  
   /* Check the parameters */
-  assert_param(IS_UART4_BAUDRATE_OK(BaudRate));
   assert_param(IS_UART4_WORDLENGTH_OK(WordLength));
   assert_param(IS_UART4_STOPBITS_OK(StopBits));
   assert_param(IS_UART4_PARITY_OK(Parity));
@@ -110,26 +107,10 @@ void UART4_Init(uint32_t BaudRate, UART4_WordLength_TypeDef WordLength, UART4_St
   /* Set the Parity Control bit to UART4_Parity value */
   UART4->CR1 |= (uint8_t)Parity;
   
-  /* Clear the LSB mantissa of UART4DIV  */
-  UART4->BRR1 &= (uint8_t)(~UART4_BRR1_DIVM);
-  /* Clear the MSB mantissa of UART4DIV  */
-  UART4->BRR2 &= (uint8_t)(~UART4_BRR2_DIVM);
-  /* Clear the Fraction bits of UART4DIV */
-  UART4->BRR2 &= (uint8_t)(~UART4_BRR2_DIVF);
-  
-  /* Set the UART4 BaudRates in BRR1 and BRR2 registers according to UART4_BaudRate value */
-  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
-  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
-  
-  /* The fraction and MSB mantissa should be loaded in one step in the BRR2 register*/
-  /* Set the fraction of UARTDIV  */
-  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
-                                << 4) / 100) & (uint8_t)0x0F); 
-  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
-  
-  UART4->BRR2 = (uint8_t)(BRR2_1 | BRR2_2);
-  /* Set the LSB mantissa of UARTDIV  */
-  UART4->BRR1 = (uint8_t)BaudRate_Mantissa;           
+  /* The fraction and MSB mantissa should be loaded in one step in the BRR2 register */
+  UART4->BRR2 = BRR2;
+  /* Set the LSB mantissa of UART4DIV, it updates the divider */
+  UART4->BRR1 = BRR1;
   
   /* Disable the Transmitter and Receiver before setting the LBCL, CPOL and CPHA bits */
   UART4->CR2 &= (uint8_t)~(UART4_CR2_TEN | UART4_CR2_REN);
@@ -172,6 +153,80 @@ void UART4_Init(uint32_t BaudRate, UART4_WordLength_TypeDef WordLength, UART4_St
   }
 }
 
+/**
+  * @brief  Initializes the UART4 according to the specified parameters.
+  * @param  BaudRate: The baudrate.
+  * @param  WordLength : This parameter can be any of the 
+  *         @ref UART4_WordLength_TypeDef enumeration.
+  * @param  StopBits: This parameter can be any of the 
+  *         @ref UART4_StopBits_TypeDef enumeration.
+  * @param  Parity: This parameter can be any of the 
+  *         @ref UART4_Parity_TypeDef enumeration.
+  * @param  SyncMode: This parameter can be any of the 
+  *         @ref UART4_SyncMode_TypeDef values.
+  * @param  Mode: This parameter can be any of the @ref UART4_Mode_TypeDef values
+  * @retval None
+  */
+void UART4_Init(uint32_t BaudRate, UART4_WordLength_TypeDef WordLength, UART4_StopBits_TypeDef StopBits, UART4_Parity_TypeDef Parity, UART4_SyncMode_TypeDef SyncMode, UART4_Mode_TypeDef Mode)
+{
+  uint8_t BRR2_1 = 0, BRR2_2 = 0;
+  uint32_t BaudRate_Mantissa = 0, BaudRate_Mantissa100 = 0;
+  
+  /* Check the parameters */
+  assert_param(IS_UART4_BAUDRATE_OK(BaudRate));
+  
+  /* Set the UART4 BaudRates in BRR1 and BRR2 registers according to UART4_BaudRate value */
+#ifdef CLK_ChangeClock_Def
+  UART4_BaudRate = BaudRate;
+#endif
+  BaudRate_Mantissa    = ((uint32_t)CLK_GetClockFreq() / (BaudRate << 4));
+  BaudRate_Mantissa100 = (((uint32_t)CLK_GetClockFreq() * 100) / (BaudRate << 4));
+  /* Set the fraction of UARTDIV  */
+  BRR2_1 = (uint8_t)((uint8_t)(((BaudRate_Mantissa100 - (BaudRate_Mantissa * 100))
+                                << 4) / 100) & (uint8_t)0x0F); 
+  BRR2_2 = (uint8_t)((BaudRate_Mantissa >> 4) & (uint8_t)0xF0);
+  
+  UART4_Config((uint8_t)BaudRate_Mantissa, (uint8_t)(BRR2_1 | BRR2_2),
+               WordLength, StopBits, Parity, SyncMode, Mode);
+}
+
+#if defined(F_CPU) && defined(UART4_BAUD)
+/**
+  * @brief  Same as UART4_Init(UART4_BAUD, ...), but baud rate registers are
+  *         computed by compiler from F_CPU (see stm8s_baud.h): no 32-bit
+  *         division at run time.
+  * @param  WordLength, StopBits, Parity, SyncMode, Mode: as in UART4_Init.
+  * @retval None
+  */
+void UART4_InitConst(UART4_WordLength_TypeDef WordLength,
+                     UART4_StopBits_TypeDef StopBits,
+                     UART4_Parity_TypeDef Parity,
+                     UART4_SyncMode_TypeDef SyncMode, UART4_Mode_TypeDef Mode)
+{
+#ifdef CLK_ChangeClock_Def
+  UART4_BaudRate = UART4_BAUD;
+#endif
+  UART4_Config(UART_BRR1(UART4_DIV), UART_BRR2(UART4_DIV),
+               WordLength, StopBits, Parity, SyncMode, Mode);
+}
+#endif
+
+#ifdef CLK_ChangeClock_Def
+/**
+  * @brief  Recalculates BRR for new fMASTER (hook for CLK_ChangeClock).
+  * @param  fmaster : new master clock, Hz
+  * @retval None
+  */
+void UART4_ClockHook(uint32_t fmaster)
+{
+  uint32_t div;
+
+  if (!UART4_BaudRate) return;
+  div = UART_DIV(fmaster, UART4_BaudRate);
+  UART_SET_DIV(UART4, div);
+}
+#endif
+
 /**
   * @brief  Enable the UART4 peripheral.
   * @param  NewState : The new state of the UART Communication.
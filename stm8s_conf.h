@@ -38,6 +38,12 @@
 // #include "inc/stm8s_delay.h" //  
 // #include "inc/stm8s_encoder.h" //   
 // #include "inc/stm8s_button.h"  //   
+// #include "inc/stm8s_hrtimer.h" // high-resolution timers on TIM2 (TIM1 with HRTIMER_USE_TIM1), needs OSA
+// #include "inc/stm8s_dfs.h" // clock scaling by CPU load, needs OSA and CLK_ChangeClock_Def
+// #include "inc/stm8s_lin.h" // LIN master/slave on UART1 (LIN_UART_NUM), needs OSA
+// #include "inc/stm8s_modbus.h" // Modbus RTU slave on UART1 (MB_UART_NUM) and TIM3 (MB_USE_TIM2)
+// #include "inc/stm8s_suart.h" // software UART channels on GPIO, needs OSA and high resolution timers
+// #include "inc/stm8s_i2cm.h" // I2C master transaction queue, needs OSA
  
  #include "inc/stm8s_clk.h" //  
 // #include "inc/stm8s_exti.h" //   
@@ -89,6 +95,7 @@
     defined (STM8AF62Ax)
 // #include "inc/stm8s_uart3.h"
 #endif /* STM8S208 || STM8S207 || STM8AF52Ax || STM8AF62Ax */ 
+// #include "inc/stm8s_uart.h" // buffered engine for all UARTs (UARTn_BUFFERED)
 //#include "inc/stm8s_wwdg.h"
 
 
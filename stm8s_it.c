@@ -109,6 +109,9 @@
 #ifdef __STM8S_UART3_H
 #include "src/stm8s_uart3.c"
 #endif
+#ifdef __STM8S_UART_H
+#include "src/stm8s_uart.c"
+#endif
 #ifdef __STM8S_WWDG_H
 #include "src/stm8s_wwdg.c"
 #endif
@@ -121,6 +124,40 @@
 #ifdef __STM8S_BUTTON_H
 #include "src/stm8s_button.c"
 #endif
+#ifdef __STM8S_HRTIMER_H
+#include "src/stm8s_hrtimer.c"
+#endif
+#ifdef __STM8S_DFS_H
+#include "src/stm8s_dfs.c"
+#endif
+#ifdef __STM8S_LIN_H
+#include "src/stm8s_lin.c"
+#endif
+#ifdef __STM8S_MODBUS_H
+#include "src/stm8s_modbus.c"
+#endif
+#ifdef __STM8S_SUART_H
+#include "src/stm8s_suart.c"
+#endif
+#ifdef __STM8S_I2CM_H
+#include "src/stm8s_i2cm.c"
+#endif
+/* One consumer per UART: buffered engine, LIN and Modbus share its handlers */
+#if defined(__STM8S_LIN_H) && defined(__STM8S_MODBUS_H) && LIN_UART_NUM == MB_UART_NUM
+#error "LIN and Modbus on the same UART: change LIN_UART_NUM or MB_UART_NUM"
+#endif
+#if defined(__STM8S_UART_H) && defined(__STM8S_LIN_H)
+#if (LIN_UART_NUM == 1 && defined(UART1_BUFFERED)) || (LIN_UART_NUM == 2 && defined(UART2_BUFFERED)) \
+	|| (LIN_UART_NUM == 3 && defined(UART3_BUFFERED))
+#error "UART of LIN (LIN_UART_NUM) is used by buffered engine (UARTn_BUFFERED)"
+#endif
+#endif
+#if defined(__STM8S_UART_H) && defined(__STM8S_MODBUS_H)
+#if (MB_UART_NUM == 1 && defined(UART1_BUFFERED)) || (MB_UART_NUM == 2 && defined(UART2_BUFFERED)) \
+	|| (MB_UART_NUM == 3 && defined(UART3_BUFFERED))
+#error "UART of Modbus (MB_UART_NUM) is used by buffered engine (UARTn_BUFFERED)"
+#endif
+#endif
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
@@ -202,6 +239,9 @@ INTERRUPT_HANDLER(EXTI_PORTA_IRQHandler, 3)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#ifdef __STM8S_SUART_H
+	SUART_ExtiIRQ(GPIOA);
+	#endif
 }
 
 /**
@@ -214,6 +254,9 @@ INTERRUPT_HANDLER(EXTI_PORTB_IRQHandler, 4)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#ifdef __STM8S_SUART_H
+	SUART_ExtiIRQ(GPIOB);
+	#endif
 }
 
 /**
@@ -226,6 +269,9 @@ INTERRUPT_HANDLER(EXTI_PORTC_IRQHandler, 5)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#ifdef __STM8S_SUART_H
+	SUART_ExtiIRQ(GPIOC);
+	#endif
 }
 
 /**
@@ -238,6 +284,9 @@ INTERRUPT_HANDLER(EXTI_PORTD_IRQHandler, 6)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#ifdef __STM8S_SUART_H
+	SUART_ExtiIRQ(GPIOD);
+	#endif
 }
 
 /**
@@ -250,6 +299,9 @@ INTERRUPT_HANDLER(EXTI_PORTE_IRQHandler, 7)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#ifdef __STM8S_SUART_H
+	SUART_ExtiIRQ(GPIOE);
+	#endif
 }
 
 #if defined (STM8S903) || defined (STM8AF622x) 
@@ -326,6 +378,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#if defined(__STM8S_SUART_H) && defined(HRTIMER_USE_TIM1)
+	SUART_IRQHandler();
+	#endif
+	#if defined(__STM8S_HRTIMER_H) && defined(HRTIMER_USE_TIM1)
+	HRT_IRQHandler();
+	#endif
 }
 
 #if defined (STM8S903) || defined (STM8AF622x)
@@ -364,6 +422,9 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#if defined(__STM8S_MODBUS_H) && defined(MB_USE_TIM2)
+	MB_TimerIRQ();
+	#endif
  }
 
 /**
@@ -376,6 +437,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+	#if defined(__STM8S_SUART_H) && !defined(HRTIMER_USE_TIM1)
+	SUART_IRQHandler();
+	#endif
+	#if defined(__STM8S_HRTIMER_H) && !defined(HRTIMER_USE_TIM1)
+	HRT_IRQHandler();
+	#endif
  }
 #endif /* (STM8S903) || (STM8AF622x) */
 
@@ -392,7 +459,9 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-	
+	#if defined(__STM8S_MODBUS_H) && !defined(MB_USE_TIM2)
+	MB_TimerIRQ();
+	#endif
  }
 
 /**
@@ -420,6 +489,12 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART1_BUFFERED
+	UART_TxIRQ(&UART_Port1);
+	#endif
+	#if defined(__STM8S_MODBUS_H) && MB_UART_NUM == 1
+	MB_TxIRQ();
+	#endif
  }
 
 /**
@@ -432,6 +507,15 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART1_BUFFERED
+	UART_RxIRQ(&UART_Port1);
+	#endif
+	#if defined(__STM8S_LIN_H) && LIN_UART_NUM == 1
+	LIN_RxIRQ();
+	#endif
+	#if defined(__STM8S_MODBUS_H) && MB_UART_NUM == 1
+	MB_RxIRQ();
+	#endif
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8S103) || (STM8S001) || (STM8S903) || (STM8AF62Ax) || (STM8AF52Ax) */
 
@@ -446,6 +530,9 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART4_BUFFERED
+	UART_TxIRQ(&UART_Port4);
+	#endif
  }
 
 /**
@@ -458,6 +545,9 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART4_BUFFERED
+	UART_RxIRQ(&UART_Port4);
+	#endif
  }
 #endif /* (STM8AF622x) */
 
@@ -466,27 +556,14 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   * @param  None
   * @retval None
   */
-	volatile uint8_t data, address=0b01111110;
-	
-	I2CEventBit_t event;
 INTERRUPT_HANDLER(I2C_IRQHandler, 19)
 {
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
-	event.event=I2C_GetLastEvent();
-	switch (event.event)
-	{	
-		case I2C_EVENT_MASTER_MODE_SELECT:
-			//I2C_GenerateSTOP();
-			I2C_Send7bitAddress(address, I2C_DIRECTION_RX);
-			//I2C_GenerateSTOP();
-			break;
-		case I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED:
-			data=I2C_ReceiveData();
-			I2C_GenerateSTOP();
-			break;		
-	}
+	#ifdef __STM8S_I2CM_H
+	I2CM_IRQHandler();
+	#endif
 }
 
 #if defined(STM8S105) || defined(STM8S005) ||  defined (STM8AF626x)
@@ -500,6 +577,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART2_BUFFERED
+	UART_TxIRQ(&UART_Port2);
+	#endif
+	#if defined(__STM8S_MODBUS_H) && MB_UART_NUM == 2
+	MB_TxIRQ();
+	#endif
  }
 
 /**
@@ -512,6 +595,15 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART2_BUFFERED
+	UART_RxIRQ(&UART_Port2);
+	#endif
+	#if defined(__STM8S_LIN_H) && LIN_UART_NUM == 2
+	LIN_RxIRQ();
+	#endif
+	#if defined(__STM8S_MODBUS_H) && MB_UART_NUM == 2
+	MB_RxIRQ();
+	#endif
  }
 #endif /* (STM8S105) || (STM8AF626x) */
 
@@ -526,6 +618,12 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART3_BUFFERED
+	UART_TxIRQ(&UART_Port3);
+	#endif
+	#if defined(__STM8S_MODBUS_H) && MB_UART_NUM == 3
+	MB_TxIRQ();
+	#endif
  }
 
 /**
@@ -538,6 +636,15 @@ INTERRUPT_HANDLER(I2C_IRQHandler, 19)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+	#ifdef UART3_BUFFERED
+	UART_RxIRQ(&UART_Port3);
+	#endif
+	#if defined(__STM8S_LIN_H) && LIN_UART_NUM == 3
+	LIN_RxIRQ();
+	#endif
+	#if defined(__STM8S_MODBUS_H) && MB_UART_NUM == 3
+	MB_RxIRQ();
+	#endif
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8AF52Ax) || (STM8AF62Ax) */
 
@@ -593,8 +700,24 @@ INTERRUPT_HANDLER(TIM6_UPD_OVF_TRG_IRQHandler, 23)
      it is recommended to set a breakpoint on the following instruction.
   */
 	#ifdef __OSA__ 
-	OS_Timer();
+	/* first: OS_GetTime_us adds period while UIF is set, tick is counted now */
 	TIM4_ClearFlag(TIM4_FLAG_UPDATE);
+	#ifdef OS_TIMER_BENCHMARK
+	TIM4_OSA_BenchStart();
+	#endif
+	OS_Timer();
+	#ifdef OS_TIMER_BENCHMARK
+	TIM4_OSA_BenchStop();
+	#endif
+	#ifdef TIM4_OSA_FRAC
+	TIM4_OSA_FracTick();
+	#endif
+	#ifdef __STM8S_DFS_H
+	DFS_Tick();
+	#endif
+	#if defined(__STM8S_LIN_H) && !defined(LIN_USE_HRTIMER)
+	LIN_Tick();
+	#endif
 	#endif
 	
  }